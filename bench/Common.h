@@ -0,0 +1,82 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#pragma once
+
+#include <simplesrp/simplesrp.h>
+#include <benchmark/benchmark.h>
+
+namespace simplesrp::bench {
+    inline const SRPBits kAllBits[] = {
+        SRPBits::Key1024,
+        SRPBits::Key1536,
+        SRPBits::Key2048,
+        SRPBits::Key3072,
+        SRPBits::Key4096,
+        SRPBits::Key6144,
+        SRPBits::Key8192,
+    };
+    
+    inline const DigestType kAllDigests[] = {
+        DigestType::SHA1,
+        DigestType::SHA224,
+        DigestType::SHA256,
+        DigestType::SHA384,
+        DigestType::SHA512,
+    };
+    
+    inline const char* const kUsername = "user@mail.com";
+    inline const char* const kPassword = "password";
+    
+    /// Reports throughput as `ops/s` next to per-iteration time.
+    inline void SetOpsRate(benchmark::State& state) {
+        state.counters["ops/s"] = benchmark::Counter(static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+    }
+    
+    /// Values of one successful handshake, used as realistic inputs of individual routines.
+    struct HandshakeValues {
+        HandshakeValues(SRPBits srpBits, DigestType digestType);
+        
+        SRPParams params;
+        SRPRoutines routines;
+        Buffer salt;
+        bn::BignumPtr x, v, k, a, A, b, B, u, clientK, serverK, M1;
+    };
+    
+    inline HandshakeValues::HandshakeValues(SRPBits srpBits, DigestType digestType)
+    : params(SRPClient(digestType, srpBits).params)
+    , salt(bn::ToBytes(bn::Random(16), 16))
+    {
+        x = routines.calculate_x(params, kUsername, kPassword, salt);
+        v = routines.calculate_A(params, x.get());
+        k = routines.calculate_k(params);
+        a = routines.randomBN(params);
+        A = routines.calculate_A(params, a.get());
+        b = routines.randomBN(params);
+        B = routines.calculate_B(params, b.get(), v.get(), k.get());
+        u = routines.calculate_u(params, A.get(), B.get());
+        clientK = routines.calculateClient_K(params, u.get(), x.get(), k.get(), a.get(), B.get());
+        serverK = routines.calculateServer_K(params, u.get(), v.get(), b.get(), A.get());
+        M1 = routines.calculate_M1(params, kUsername, salt, A.get(), B.get(), clientK.get());
+    }
+}
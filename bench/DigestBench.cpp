@@ -0,0 +1,68 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Common.h"
+
+#include <simplesrp/multihash.h>
+
+using namespace simplesrp;
+using namespace simplesrp::bench;
+
+namespace {
+    // 256 independent messages through `utils::MultiDigest`.
+    // Arguments: index in `kAllDigests`, path (0 = scalar, 1 = AVX2, 2 = AVX-512), message size.
+    void BM_MultiDigest(benchmark::State& state) {
+        const DigestType digestType = kAllDigests[state.range(0)];
+        const utils::MultiDigest multiDigest(digestType, static_cast<utils::MultiDigestPath>(state.range(1)));
+        if (static_cast<int64_t>(multiDigest.path()) != state.range(1)) {
+            state.SkipWithError("Path is not supported");
+            return;
+        }
+        
+        const size_t count = 256;
+        const size_t size = static_cast<size_t>(state.range(2));
+        Buffer input(count * size, 0x5a);
+        Buffer output(count * DigestSize(digestType));
+        std::vector<const uint8_t*> data(count);
+        std::vector<size_t> sizes(count, size);
+        std::vector<uint8_t*> hashes(count);
+        for (size_t i = 0; i < count; i++) {
+            data[i] = input.data() + i * size;
+            hashes[i] = output.data() + i * DigestSize(digestType);
+        }
+        
+        for (auto _ : state) {
+            multiDigest.hash(count, data.data(), sizes.data(), hashes.data());
+            benchmark::DoNotOptimize(output.data());
+        }
+        
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * count * size));
+        state.counters["ops/s"] = benchmark::Counter(static_cast<double>(state.iterations() * count), benchmark::Counter::kIsRate);
+    }
+}
+
+BENCHMARK(BM_MultiDigest)
+    ->ArgNames({ "digest", "path", "size" })
+    ->ArgsProduct({ benchmark::CreateDenseRange(0, 4, 1), { 0, 1, 2 }, { 64, 512 } })
+    ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,92 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Common.h"
+
+#include <simplesrp/random.h>
+
+#include <openssl/rand.h>
+
+using namespace simplesrp;
+using namespace simplesrp::bench;
+
+namespace {
+    // Server + client handshake excluding verifier generation.
+    // Arguments: index in `kAllBits`, private ephemeral exponent length (0 = size of N).
+    void BM_HandshakeEphemeralBits(benchmark::State& state) {
+        const SRPBits srpBits = kAllBits[state.range(0)];
+        const size_t ephemeralBits = static_cast<size_t>(state.range(1));
+        const std::string username = kUsername;
+        const std::string password = kPassword;
+        
+        SRPVerifierGenerator gen(DigestType::SHA256, srpBits);
+        Buffer salt;
+        Buffer verifier;
+        gen.generate(username, password, 16, salt, verifier);
+        
+        for (auto _ : state) {
+            SRPClient client(DigestType::SHA256, srpBits);
+            client.params.ephemeralBits = ephemeralBits;
+            SRPServer server(DigestType::SHA256, srpBits);
+            server.params.ephemeralBits = ephemeralBits;
+            
+            Buffer A, B, M1, M2;
+            client.startAuthentication(A);
+            server.startAuthentication(username, salt, verifier, B);
+            client.processChallenge(username, password, salt, B, M1);
+            if (!server.verifySession(A, M1, M2) || !client.verifySession(M2)) {
+                state.SkipWithError("Handshake failed");
+                break;
+            }
+        }
+        
+        SetOpsRate(state);
+    }
+    
+    // Secret bytes of N size from the per-thread DRBG and from OpenSSL's private DRBG.
+    // Arguments: index in `kAllBits`.
+    void BM_RandomBytes(benchmark::State& state) {
+        Buffer bytes(BN_num_bytes(SRPRoutines::gN(kAllBits[state.range(0)])->N));
+        for (auto _ : state) {
+            utils::RandomBytes(bytes.data(), bytes.size());
+        }
+        SetOpsRate(state);
+    }
+    
+    void BM_RandPrivBytes(benchmark::State& state) {
+        Buffer bytes(BN_num_bytes(SRPRoutines::gN(kAllBits[state.range(0)])->N));
+        for (auto _ : state) {
+            RAND_priv_bytes(bytes.data(), static_cast<int>(bytes.size()));
+        }
+        SetOpsRate(state);
+    }
+}
+
+BENCHMARK(BM_RandomBytes)->ArgName("bits")->DenseRange(0, 6, 1)->ThreadRange(1, 8);
+BENCHMARK(BM_RandPrivBytes)->ArgName("bits")->DenseRange(0, 6, 1)->ThreadRange(1, 8);
+
+BENCHMARK(BM_HandshakeEphemeralBits)
+    ->ArgNames({ "bits", "ephemeral" })
+    ->ArgsProduct({ benchmark::CreateDenseRange(0, 6, 1), { 0, 256, 384 } })
+    ->Unit(benchmark::kMillisecond);
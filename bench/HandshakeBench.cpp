@@ -0,0 +1,327 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Common.h"
+
+#include <simplesrp/basic.h>
+#include <simplesrp/seal.h>
+
+#include <cstring>
+#include <memory>
+
+using namespace simplesrp;
+using namespace simplesrp::bench;
+
+namespace {
+    // Complete client + server handshake, every group size and digest.
+    // Arguments: index in `kAllBits`, index in `kAllDigests`.
+    void BM_Handshake(benchmark::State& state) {
+        const SRPBits srpBits = kAllBits[state.range(0)];
+        const DigestType digestType = kAllDigests[state.range(1)];
+        
+        SRPVerifierGenerator gen(digestType, srpBits);
+        Buffer salt;
+        Buffer verifier;
+        gen.generate(kUsername, kPassword, 16, salt, verifier);
+        
+        for (auto _ : state) {
+            SRPClient client(digestType, srpBits);
+            SRPServer server(digestType, srpBits);
+            
+            Buffer A, B, M1, M2;
+            client.startAuthentication(A);
+            server.startAuthentication(kUsername, salt, verifier, B);
+            client.processChallenge(kUsername, kPassword, salt, B, M1);
+            if (!server.verifySession(A, M1, M2) || !client.verifySession(M2)) {
+                state.SkipWithError("Handshake failed");
+                break;
+            }
+        }
+        
+        SetOpsRate(state);
+    }
+    
+    // Reconnect with a resumption ticket from a full handshake, to compare with `BM_Handshake`.
+    // Arguments: index in `kAllBits`, index in `kAllDigests`.
+    void BM_Resumption(benchmark::State& state) {
+        const SRPBits srpBits = kAllBits[state.range(0)];
+        const DigestType digestType = kAllDigests[state.range(1)];
+        
+        SRPVerifierGenerator gen(digestType, srpBits);
+        Buffer salt;
+        Buffer verifier;
+        gen.generate(kUsername, kPassword, 16, salt, verifier);
+        
+        const Buffer key(utils::SealKeySize, 0x5a);
+        Buffer ticket, K;
+        {
+            SRPClient client(digestType, srpBits);
+            SRPServer server(digestType, srpBits);
+            Buffer A, B, M1, M2;
+            client.startAuthentication(A);
+            server.startAuthentication(kUsername, salt, verifier, B);
+            client.processChallenge(kUsername, kPassword, salt, B, M1);
+            if (!server.verifySession(A, M1, M2) || !server.issueTicket(key, std::chrono::minutes(10), ticket)) {
+                state.SkipWithError("Handshake failed");
+                return;
+            }
+            K = client.sessionKey();
+        }
+        
+        for (auto _ : state) {
+            SRPClient client(digestType, srpBits);
+            SRPServer server(digestType, srpBits);
+            
+            Buffer clientNonce, serverNonce, M1, M2;
+            std::string username;
+            if (!client.startResumption(K, clientNonce)
+                || !server.startResumption(key, ticket, clientNonce, username, serverNonce)
+                || !client.processResumption(serverNonce, M1)
+                || !server.verifyResumption(M1, M2)
+                || !client.verifyResumption(M2)) {
+                state.SkipWithError("Resumption failed");
+                break;
+            }
+        }
+        
+        SetOpsRate(state);
+    }
+    
+    // Encoding and decoding of the four messages of one handshake by `SRPWireCodec`.
+    // Argument: index in `kAllBits`.
+    void BM_WireCodec(benchmark::State& state) {
+        const HandshakeValues h(kAllBits[state.range(0)], DigestType::SHA256);
+        const SRPWireCodec codec(h.params.digestType, kAllBits[state.range(0)]);
+        const Buffer A = bn::ToBytes(h.A.get());
+        const Buffer B = bn::ToBytes(h.B.get());
+        const Buffer M1 = bn::ToBytes(h.M1.get());
+        const size_t usernameSize = strlen(kUsername);
+        Buffer wire(codec.clientHelloSize(usernameSize) + codec.serverChallengeSize(h.salt.size()));
+        
+        for (auto _ : state) {
+            SRPClientHelloView hello;
+            SRPServerChallengeView challenge;
+            SRPProofView proof;
+            size_t size = codec.encodeClientHello(kUsername, usernameSize, A.data(), A.size(), wire.data(), wire.size());
+            bool ok = codec.decodeClientHello(wire.data(), size, hello);
+            size = codec.encodeServerChallenge(h.salt.data(), h.salt.size(), B.data(), B.size(), wire.data(), wire.size());
+            ok = ok && codec.decodeServerChallenge(wire.data(), size, challenge);
+            size = codec.encodeClientProof(M1.data(), M1.size(), wire.data(), wire.size());
+            ok = ok && codec.decodeClientProof(wire.data(), size, proof);
+            size = codec.encodeServerProof(M1.data(), M1.size(), wire.data(), wire.size());
+            ok = ok && codec.decodeServerProof(wire.data(), size, proof);
+            benchmark::DoNotOptimize(ok);
+        }
+        
+        SetOpsRate(state);
+    }
+    
+    // Complete handshake of `BasicSRPClient` and `BasicSRPServer`, to compare with `BM_Handshake`.
+    template <SRPBits Bits, DigestType Type>
+    void BM_BasicHandshake(benchmark::State& state) {
+        using Client = BasicSRPClient<Bits, Type>;
+        using Server = BasicSRPServer<Bits, Type>;
+        
+        SRPVerifierGenerator gen(Type, Bits);
+        Buffer salt;
+        Buffer verifier;
+        gen.generate(kUsername, kPassword, 16, salt, verifier);
+        
+        const std::string username = kUsername;
+        const std::string password = kPassword;
+        
+        Client client;
+        Server server;
+        for (auto _ : state) {
+            typename Client::PublicValue A;
+            typename Server::PublicValue B;
+            typename Client::Hash M1, M2;
+            size_t M1Size = 0, M2Size = 0;
+            client.startAuthentication(A);
+            server.startAuthentication(username.data(), username.size(), salt.data(), salt.size(),
+                                       verifier.data(), verifier.size(), B);
+            client.processChallenge(username.data(), username.size(), password.data(), password.size(),
+                                    salt.data(), salt.size(), B.data(), B.size(), M1, M1Size);
+            if (!server.verifySession(A.data(), A.size(), M1.data(), M1Size, M2, M2Size)
+                || !client.verifySession(M2.data(), M2Size)) {
+                state.SkipWithError("Handshake failed");
+                break;
+            }
+        }
+        
+        SetOpsRate(state);
+    }
+    
+    // Server `startAuthentication` with and without ephemeral pool and precomputed kv, SHA256.
+    // The pool is prefilled for all iterations, so it measures request path latency only.
+    // Arguments: index in `kAllBits`, pool size (0 = no pool), kv (0 = computed per call, 1 = precomputed).
+    void BM_ServerStartAuthentication(benchmark::State& state) {
+        const SRPBits srpBits = kAllBits[state.range(0)];
+        const size_t poolSize = static_cast<size_t>(state.range(1));
+        const bool precomputedKV = state.range(2) != 0;
+        
+        SRPVerifierGenerator gen(DigestType::SHA256, srpBits);
+        Buffer salt;
+        Buffer verifier;
+        Buffer kv;
+        gen.generate(kUsername, kPassword, 16, salt, verifier);
+        gen.generateKV(verifier, kv);
+        
+        SRPServer server(DigestType::SHA256, srpBits);
+        if (poolSize) {
+            server.ephemeralPool = std::make_shared<SRPEphemeralPool>(server.params, server.routines, 0, poolSize);
+            server.ephemeralPool->prefill();
+        }
+        
+        for (auto _ : state) {
+            Buffer B;
+            if (precomputedKV) {
+                server.startAuthentication(kUsername, salt, verifier, kv, B);
+            } else {
+                server.startAuthentication(kUsername, salt, verifier, B);
+            }
+            benchmark::DoNotOptimize(B.data());
+        }
+        
+        SetOpsRate(state);
+    }
+    
+    // Server verification of 64 started sessions, one `verifySession` call each or one
+    // `verifySessions` call, SHA256. Verification does not change session state, so the same
+    // sessions are verified on every iteration.
+    // Arguments: index in `kAllBits`, batch (0 = `verifySession` loop, 1 = `verifySessions`).
+    void BM_ServerVerifySessions(benchmark::State& state) {
+        const SRPBits srpBits = kAllBits[state.range(0)];
+        const bool batch = state.range(1) != 0;
+        
+        SRPVerifierGenerator gen(DigestType::SHA256, srpBits);
+        Buffer salt;
+        Buffer verifier;
+        gen.generate(kUsername, kPassword, 16, salt, verifier);
+        
+        std::vector<std::unique_ptr<SRPServer>> servers;
+        std::vector<SRPServer::Verification> items(64);
+        for (auto& item : items) {
+            SRPClient client(DigestType::SHA256, srpBits);
+            servers.push_back(std::make_unique<SRPServer>(DigestType::SHA256, srpBits));
+            
+            Buffer B;
+            client.startAuthentication(item.A);
+            servers.back()->startAuthentication(kUsername, salt, verifier, B);
+            client.processChallenge(kUsername, kPassword, salt, B, item.M1);
+            item.server = servers.back().get();
+        }
+        
+        for (auto _ : state) {
+            if (batch) {
+                SRPServer::verifySessions(items.data(), items.size());
+            } else {
+                for (auto& item : items) {
+                    item.verified = item.server->verifySession(item.A, item.M1, item.M2);
+                }
+            }
+            if (!items.back().verified) {
+                state.SkipWithError("Verification failed");
+                break;
+            }
+        }
+        
+        state.counters["ops/s"] = benchmark::Counter(static_cast<double>(state.iterations() * items.size()), benchmark::Counter::kIsRate);
+    }
+    
+    // Verifier generation with random salt, every group size and digest.
+    // Arguments: index in `kAllBits`, index in `kAllDigests`.
+    void BM_VerifierGeneration(benchmark::State& state) {
+        SRPVerifierGenerator gen(kAllDigests[state.range(1)], kAllBits[state.range(0)]);
+        for (auto _ : state) {
+            Buffer salt;
+            Buffer verifier;
+            gen.generate(kUsername, kPassword, 16, salt, verifier);
+            benchmark::DoNotOptimize(verifier.data());
+        }
+        
+        SetOpsRate(state);
+    }
+    
+    // Batch verifier generation of 256 records on all hardware threads, SHA256.
+    // Argument: index in `kAllBits`.
+    void BM_VerifierGenerationBatch(benchmark::State& state) {
+        SRPVerifierGenerator gen(DigestType::SHA256, kAllBits[state.range(0)]);
+        utils::ThreadPool pool;
+        
+        std::vector<SRPVerifierGenerator::Record> records(256);
+        for (size_t i = 0; i < records.size(); i++) {
+            records[i].username = "user" + std::to_string(i);
+            records[i].password = kPassword;
+            records[i].saltSize = 16;
+        }
+        
+        for (auto _ : state) {
+            for (auto& record : records) {
+                record.salt.clear();
+            }
+            gen.generate(records.data(), records.size(), pool);
+        }
+        
+        state.counters["ops/s"] = benchmark::Counter(static_cast<double>(state.iterations() * records.size()), benchmark::Counter::kIsRate);
+    }
+}
+
+BENCHMARK(BM_Handshake)
+    ->ArgNames({ "bits", "digest" })
+    ->ArgsProduct({ benchmark::CreateDenseRange(0, 6, 1), benchmark::CreateDenseRange(0, 4, 1) })
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_Resumption)
+    ->ArgNames({ "bits", "digest" })
+    ->ArgsProduct({ { 0, 2, 4, 6 }, { 0, 2 } })
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_WireCodec)->ArgName("bits")->DenseRange(0, 6, 1);
+
+BENCHMARK_TEMPLATE(BM_BasicHandshake, SRPBits::Key1024, DigestType::SHA1)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_BasicHandshake, SRPBits::Key2048, DigestType::SHA256)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_BasicHandshake, SRPBits::Key4096, DigestType::SHA256)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_ServerStartAuthentication)
+    ->ArgNames({ "bits", "pool", "kv" })
+    ->ArgsProduct({ benchmark::CreateDenseRange(0, 6, 1), { 0, 64 }, { 0, 1 } })
+    ->Iterations(64)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_ServerVerifySessions)
+    ->ArgNames({ "bits", "batch" })
+    ->ArgsProduct({ benchmark::CreateDenseRange(0, 6, 1), { 0, 1 } })
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_VerifierGeneration)
+    ->ArgNames({ "bits", "digest" })
+    ->ArgsProduct({ benchmark::CreateDenseRange(0, 6, 1), benchmark::CreateDenseRange(0, 4, 1) })
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_VerifierGenerationBatch)
+    ->ArgName("bits")
+    ->DenseRange(0, 6, 1)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -0,0 +1,127 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Common.h"
+
+using namespace simplesrp;
+using namespace simplesrp::bench;
+
+// Each routine of default `SRPRoutines` for every group size with SHA256.
+// Argument: index in `kAllBits`.
+
+#define SSRP_ROUTINE_BENCHMARK(name, ...)                                   \
+    static void BM_Routine_##name(benchmark::State& state) {                \
+        const HandshakeValues h(kAllBits[state.range(0)], DigestType::SHA256); \
+        for (auto _ : state) {                                              \
+            benchmark::DoNotOptimize(h.routines.name(h.params, __VA_ARGS__)); \
+        }                                                                   \
+        SetOpsRate(state);                                                  \
+    }                                                                       \
+    BENCHMARK(BM_Routine_##name)->ArgName("bits")->DenseRange(0, 6, 1)
+
+#define SSRP_ROUTINE_BENCHMARK_NOARGS(name)                                 \
+    static void BM_Routine_##name(benchmark::State& state) {                \
+        const HandshakeValues h(kAllBits[state.range(0)], DigestType::SHA256); \
+        for (auto _ : state) {                                              \
+            benchmark::DoNotOptimize(h.routines.name(h.params));            \
+        }                                                                   \
+        SetOpsRate(state);                                                  \
+    }                                                                       \
+    BENCHMARK(BM_Routine_##name)->ArgName("bits")->DenseRange(0, 6, 1)
+
+SSRP_ROUTINE_BENCHMARK_NOARGS(randomBN);
+SSRP_ROUTINE_BENCHMARK(calculate_A, h.a.get());
+SSRP_ROUTINE_BENCHMARK(calculate_B, h.b.get(), h.v.get(), h.k.get());
+SSRP_ROUTINE_BENCHMARK_NOARGS(calculate_k);
+SSRP_ROUTINE_BENCHMARK(calculate_x, kUsername, kPassword, h.salt);
+SSRP_ROUTINE_BENCHMARK(calculate_u, h.A.get(), h.B.get());
+SSRP_ROUTINE_BENCHMARK(calculateClient_K, h.u.get(), h.x.get(), h.k.get(), h.a.get(), h.B.get());
+SSRP_ROUTINE_BENCHMARK(calculateServer_K, h.u.get(), h.v.get(), h.b.get(), h.A.get());
+SSRP_ROUTINE_BENCHMARK(calculate_M1, kUsername, h.salt, h.A.get(), h.B.get(), h.clientK.get());
+SSRP_ROUTINE_BENCHMARK(calculate_M2, h.A.get(), h.M1.get(), h.clientK.get());
+SSRP_ROUTINE_BENCHMARK(clientSafetyCheck, h.B.get(), h.u.get());
+SSRP_ROUTINE_BENCHMARK(serverSafetyCheck, h.A.get());
+
+// Exponentiation routines after `SRPRoutines::useNativeExponentiation()`, to compare with the above.
+// Argument: index in `kAllBits`.
+
+#define SSRP_NATIVE_ROUTINE_BENCHMARK(name, ...)                            \
+    static void BM_NativeRoutine_##name(benchmark::State& state) {          \
+        const HandshakeValues h(kAllBits[state.range(0)], DigestType::SHA256); \
+        SRPRoutines routines;                                               \
+        routines.useNativeExponentiation();                                 \
+        for (auto _ : state) {                                              \
+            benchmark::DoNotOptimize(routines.name(h.params, __VA_ARGS__)); \
+        }                                                                   \
+        SetOpsRate(state);                                                  \
+    }                                                                       \
+    BENCHMARK(BM_NativeRoutine_##name)->ArgName("bits")->DenseRange(0, 6, 1)
+
+SSRP_NATIVE_ROUTINE_BENCHMARK(calculate_A, h.a.get());
+SSRP_NATIVE_ROUTINE_BENCHMARK(calculate_B, h.b.get(), h.v.get(), h.k.get());
+SSRP_NATIVE_ROUTINE_BENCHMARK(calculateClient_K, h.u.get(), h.x.get(), h.k.get(), h.a.get(), h.B.get());
+SSRP_NATIVE_ROUTINE_BENCHMARK(calculateServer_K, h.u.get(), h.v.get(), h.b.get(), h.A.get());
+
+// Latency of a single calculate_A/calculate_B split over a pool; compare with BM_Routine_*.
+// Arguments: index in `kAllBits`, pool threads.
+
+#define SSRP_PARALLEL_ROUTINE_BENCHMARK(name, ...)                              \
+    static void BM_ParallelRoutine_##name(benchmark::State& state) {            \
+        const HandshakeValues h(kAllBits[state.range(0)], DigestType::SHA256);  \
+        SRPRoutines routines;                                                   \
+        routines.useParallelExponentiation(                                     \
+            std::make_shared<utils::ThreadPool>(state.range(1)));               \
+        for (auto _ : state) {                                                  \
+            benchmark::DoNotOptimize(routines.name(h.params, __VA_ARGS__));     \
+        }                                                                       \
+        SetOpsRate(state);                                                      \
+    }                                                                           \
+    BENCHMARK(BM_ParallelRoutine_##name)                                        \
+        ->ArgNames({ "bits", "threads" })                                       \
+        ->ArgsProduct({ benchmark::CreateDenseRange(0, 6, 1), { 2, 4 } })       \
+        ->UseRealTime()
+
+SSRP_PARALLEL_ROUTINE_BENCHMARK(calculate_A, h.a.get());
+SSRP_PARALLEL_ROUTINE_BENCHMARK(calculate_B, h.b.get(), h.v.get(), h.k.get());
+
+// `bn::ModExp` of the bignum backend the library is built with, labelled with its name.
+// Arguments: index in `kAllBits`, exponent bits (0 = size of N).
+static void BM_BackendModExp(benchmark::State& state) {
+    const BIGNUM* N = SRPRoutines::gN(kAllBits[state.range(0)])->N;
+    const size_t exponentBits = state.range(1) ? static_cast<size_t>(state.range(1)) : BN_num_bits(N);
+    auto mont = bn::MakeMontContext(N);
+    auto a = bn::Random(BN_num_bytes(N) - 1);
+    auto p = bn::RandomBits(exponentBits);
+    auto r = bn::New();
+    for (auto _ : state) {
+        bn::ModExp(r.get(), a.get(), p.get(), N, mont.get(), bn::ThreadContext());
+    }
+    
+    state.SetLabel(bn::BackendName());
+    SetOpsRate(state);
+}
+BENCHMARK(BM_BackendModExp)
+    ->ArgNames({ "bits", "exponent" })
+    ->ArgsProduct({ benchmark::CreateDenseRange(0, 6, 1), { 256, 0 } })
+    ->Unit(benchmark::kMicrosecond);
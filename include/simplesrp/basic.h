@@ -0,0 +1,316 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#pragma once
+
+#include <simplesrp/core.h>
+
+#include <array>
+#include <type_traits>
+
+namespace simplesrp {
+    namespace utils {
+        /// Digest with the algorithm fixed at compile time. Interchangeable with `Digest`
+        /// in `core` hashing steps; the constructor argument exists only for that.
+        template <DigestType Type>
+        class StaticDigest {
+        public:
+            static constexpr size_t Size = DigestSize(Type);
+            
+            explicit StaticDigest(DigestType = Type) {
+                SSRP_DISABLE_DEPRECATION_WARNINGS
+                if constexpr (Type == DigestType::SHA1) {
+                    SHA1_Init(&m_ctx);
+                } else if constexpr (Type == DigestType::SHA224) {
+                    SHA224_Init(&m_ctx);
+                } else if constexpr (Type == DigestType::SHA256) {
+                    SHA256_Init(&m_ctx);
+                } else if constexpr (Type == DigestType::SHA384) {
+                    SHA384_Init(&m_ctx);
+                } else {
+                    SHA512_Init(&m_ctx);
+                }
+                SSRP_ENABLE_DEPRECATION_WARNINGS
+            }
+            
+            void update(const void* ptr, size_t size) {
+                SSRP_DISABLE_DEPRECATION_WARNINGS
+                if constexpr (Type == DigestType::SHA1) {
+                    SHA1_Update(&m_ctx, ptr, size);
+                } else if constexpr (Type == DigestType::SHA224) {
+                    SHA224_Update(&m_ctx, ptr, size);
+                } else if constexpr (Type == DigestType::SHA256) {
+                    SHA256_Update(&m_ctx, ptr, size);
+                } else if constexpr (Type == DigestType::SHA384) {
+                    SHA384_Update(&m_ctx, ptr, size);
+                } else {
+                    SHA512_Update(&m_ctx, ptr, size);
+                }
+                SSRP_ENABLE_DEPRECATION_WARNINGS
+            }
+            
+            /// Writes `Size` bytes into `hash`.
+            void final(uint8_t* hash) {
+                SSRP_DISABLE_DEPRECATION_WARNINGS
+                if constexpr (Type == DigestType::SHA1) {
+                    SHA1_Final(hash, &m_ctx);
+                } else if constexpr (Type == DigestType::SHA224) {
+                    SHA224_Final(hash, &m_ctx);
+                } else if constexpr (Type == DigestType::SHA256) {
+                    SHA256_Final(hash, &m_ctx);
+                } else if constexpr (Type == DigestType::SHA384) {
+                    SHA384_Final(hash, &m_ctx);
+                } else {
+                    SHA512_Final(hash, &m_ctx);
+                }
+                SSRP_ENABLE_DEPRECATION_WARNINGS
+            }
+            
+            static constexpr size_t hashSize() { return Size; }
+            
+        private:
+            using Context = std::conditional_t<Type == DigestType::SHA1, SHA_CTX,
+                            std::conditional_t<Type == DigestType::SHA224 || Type == DigestType::SHA256, SHA256_CTX,
+                            SHA512_CTX>>;
+            Context m_ctx = {};
+        };
+    }
+    
+    /// Common part of `BasicSRPClient` and `BasicSRPServer`: configuration fixed at compile time
+    /// and storage sized for it.
+    template <SRPBits Bits, DigestType Type, Flags Options, size_t EphemeralBits>
+    class BasicSRPBase {
+    public:
+        static constexpr size_t NSize = BignumSize(Bits);
+        static constexpr size_t HashSize = DigestSize(Type);
+        static constexpr size_t ExponentBits = EphemeralBits ? EphemeralBits : NSize * 8;
+        
+        static_assert(NSize > 0 && HashSize > 0, "Unknown SRPBits or DigestType");
+        static_assert(ExponentBits >= core::MinEphemeralBits && ExponentBits <= NSize * 8, "EphemeralBits out of range");
+        
+        /// A and B, left-padded to the size of N.
+        using PublicValue = std::array<uint8_t, NSize>;
+        
+        /// M1, M2 and K.
+        using Hash = std::array<uint8_t, HashSize>;
+        
+        using Digest = utils::StaticDigest<Type>;
+        
+        BasicSRPBase(const BasicSRPBase&) = delete;
+        BasicSRPBase& operator=(const BasicSRPBase&) = delete;
+        
+        /// Writes the session key without leading zero bytes as `SRPClient`/`SRPServer` return it.
+        /// Returns number of written bytes, zero if session is not established.
+        size_t sessionKey(Hash& K) const {
+            return m_hasKey ? core::CopyStripped(m_K.data(), HashSize, K.data(), HashSize) : 0;
+        }
+        
+    protected:
+        BasicSRPBase()
+        : m_group(*SRPGroup::Get(SRPRoutines::gN(Bits), Type, Options))
+        {}
+        
+        static bool ReadBignum(const uint8_t* data, size_t size, BIGNUM* bn) {
+            return size <= NSize && BN_bin2bn(data, static_cast<int>(size), bn);
+        }
+        
+        const SRPGroup& m_group;
+        bn::BignumPtr m_A = bn::New();
+        bn::BignumPtr m_B = bn::New();
+        bn::BignumPtr m_u = bn::New();
+        bn::BignumPtr m_S = bn::New();
+        PublicValue m_scratch = {};
+        Hash m_K = {};
+        bool m_hasKey = false;
+    };
+    
+    /// SRP client with group, digest and flags fixed at compile time.
+    /// Computations are the built-in ones of `SRPRawClient`, dispatched statically, and results are
+    /// wire-compatible with `SRPClient`/`SRPServer` of the same configuration.
+    /// Proofs and the session key are produced without leading zero bytes, so their actual
+    /// size is returned next to the fixed-size array.
+    template <SRPBits Bits, DigestType Type, Flags Options = Flags{}, size_t EphemeralBits = 0>
+    class BasicSRPClient : public BasicSRPBase<Bits, Type, Options, EphemeralBits> {
+        using Base = BasicSRPBase<Bits, Type, Options, EphemeralBits>;
+        
+    public:
+        using typename Base::PublicValue;
+        using typename Base::Hash;
+        using typename Base::Digest;
+        
+        BasicSRPClient() = default;
+        
+        bool startAuthentication(PublicValue& A) {
+            this->m_hasKey = false;
+            return bn::RandomBits(m_a.get(), Base::ExponentBits)
+                && core::Calculate_A(this->m_group, m_a.get(), this->m_A.get(), bn::ThreadContext())
+                && BN_bn2binpad(this->m_A.get(), A.data(), Base::NSize) >= 0;
+        }
+        
+        bool processChallenge(const char* username, size_t usernameSize,
+                              const char* password, size_t passwordSize,
+                              const uint8_t* salt, size_t saltSize,
+                              const uint8_t* B, size_t BSize,
+                              Hash& M1, size_t& M1Size) {
+            this->m_hasKey = false;
+            
+            const SRPGroup& group = this->m_group;
+            uint8_t* scratch = this->m_scratch.data();
+            BN_CTX* ctx = bn::ThreadContext();
+            if (!Base::ReadBignum(B, BSize, this->m_B.get())) {
+                return false;
+            }
+            
+            Hash hash;
+            core::Calculate_u<Digest>(group, this->m_A.get(), this->m_B.get(), scratch, hash.data());
+            BN_bin2bn(hash.data(), Base::HashSize, this->m_u.get());
+            if (!core::ClientSafetyCheck(this->m_B.get(), this->m_u.get())) {
+                return false;
+            }
+            
+            core::Calculate_x<Digest>(group, username, usernameSize, password, passwordSize, salt, saltSize, hash.data());
+            BN_bin2bn(hash.data(), Base::HashSize, m_x.get());
+            
+            if (!core::ClientPremaster(group, this->m_u.get(), m_x.get(), group.k.get(), m_a.get(),
+                                       this->m_B.get(), this->m_S.get(), ctx)) {
+                return false;
+            }
+            core::Calculate_K<Digest>(group, this->m_S.get(), scratch, this->m_K.data());
+            
+            Digest di = core::BeginM1<Digest>(group, username, usernameSize, salt, saltSize);
+            core::FinishM1(group, di, this->m_A.get(), this->m_B.get(), this->m_K.data(), Base::HashSize, scratch, hash.data());
+            core::Calculate_M2<Digest>(group, this->m_A.get(), hash.data(), Base::HashSize,
+                                       this->m_K.data(), Base::HashSize, scratch, m_M2.data());
+            
+            M1Size = core::CopyStripped(hash.data(), Base::HashSize, M1.data(), Base::HashSize);
+            this->m_hasKey = M1Size > 0;
+            return this->m_hasKey;
+        }
+        
+        bool verifySession(const uint8_t* M2, size_t M2Size) const {
+            return this->m_hasKey && core::EqualStripped(m_M2.data(), Base::HashSize, M2, M2Size);
+        }
+        
+    private:
+        bn::BignumPtr m_a = bn::New();
+        bn::BignumPtr m_x = bn::New();
+        Hash m_M2 = {};
+    };
+    
+    /// SRP server with group, digest and flags fixed at compile time. See `BasicSRPClient`.
+    template <SRPBits Bits, DigestType Type, Flags Options = Flags{}, size_t EphemeralBits = 0>
+    class BasicSRPServer : public BasicSRPBase<Bits, Type, Options, EphemeralBits> {
+        using Base = BasicSRPBase<Bits, Type, Options, EphemeralBits>;
+        
+    public:
+        using typename Base::PublicValue;
+        using typename Base::Hash;
+        using typename Base::Digest;
+        
+        BasicSRPServer() = default;
+        
+        bool startAuthentication(const char* username, size_t usernameSize,
+                                 const uint8_t* salt, size_t saltSize,
+                                 const uint8_t* verifier, size_t verifierSize,
+                                 PublicValue& B) {
+            return startAuthentication(username, usernameSize, salt, saltSize, verifier, verifierSize, nullptr, 0, B);
+        }
+        
+        /// Same as above with precomputed `kv` = k*v mod N, see `SRPVerifierGenerator::generateKV`.
+        /// Fails if `kv` is not less than N.
+        bool startAuthentication(const char* username, size_t usernameSize,
+                                 const uint8_t* salt, size_t saltSize,
+                                 const uint8_t* verifier, size_t verifierSize,
+                                 const uint8_t* kv, size_t kvSize,
+                                 PublicValue& B) {
+            m_started = false;
+            this->m_hasKey = false;
+            
+            const SRPGroup& group = this->m_group;
+            BN_CTX* ctx = bn::ThreadContext();
+            
+            // m_S holds g^b until the premaster secret is computed.
+            if (!Base::ReadBignum(verifier, verifierSize, m_v.get())
+                || !bn::RandomBits(m_b.get(), Base::ExponentBits)
+                || !core::Calculate_A(group, m_b.get(), this->m_S.get(), ctx)) {
+                return false;
+            }
+            
+            const bool combined = kv
+                ? Base::ReadBignum(kv, kvSize, m_kv.get()) && bn::Compare(m_kv.get(), group.gn->N) < 0
+                    && core::CombineKV_B(group, this->m_S.get(), m_kv.get(), this->m_B.get(), ctx)
+                : core::Combine_B(group, this->m_S.get(), m_v.get(), group.k.get(), this->m_B.get(), ctx);
+            if (!combined || BN_bn2binpad(this->m_B.get(), B.data(), Base::NSize) < 0) {
+                return false;
+            }
+            
+            m_M1Prefix = core::BeginM1<Digest>(group, username, usernameSize, salt, saltSize);
+            m_started = true;
+            return true;
+        }
+        
+        bool verifySession(const uint8_t* A, size_t ASize,
+                           const uint8_t* M1, size_t M1Size,
+                           Hash& M2, size_t& M2Size) {
+            this->m_hasKey = false;
+            if (!m_started) {
+                return false;
+            }
+            
+            const SRPGroup& group = this->m_group;
+            uint8_t* scratch = this->m_scratch.data();
+            BN_CTX* ctx = bn::ThreadContext();
+            if (!Base::ReadBignum(A, ASize, this->m_A.get()) || !core::ServerSafetyCheck(group, this->m_A.get(), ctx)) {
+                return false;
+            }
+            
+            Hash hash;
+            core::Calculate_u<Digest>(group, this->m_A.get(), this->m_B.get(), scratch, hash.data());
+            BN_bin2bn(hash.data(), Base::HashSize, this->m_u.get());
+            if (!core::ServerPremaster(group, this->m_u.get(), m_v.get(), m_b.get(), this->m_A.get(), this->m_S.get(), ctx)) {
+                return false;
+            }
+            core::Calculate_K<Digest>(group, this->m_S.get(), scratch, this->m_K.data());
+            
+            Digest di = m_M1Prefix;
+            core::FinishM1(group, di, this->m_A.get(), this->m_B.get(), this->m_K.data(), Base::HashSize, scratch, hash.data());
+            if (!core::EqualStripped(hash.data(), Base::HashSize, M1, M1Size)) {
+                return false;
+            }
+            
+            Hash serverM2;
+            core::Calculate_M2<Digest>(group, this->m_A.get(), hash.data(), Base::HashSize,
+                                       this->m_K.data(), Base::HashSize, scratch, serverM2.data());
+            M2Size = core::CopyStripped(serverM2.data(), Base::HashSize, M2.data(), Base::HashSize);
+            this->m_hasKey = M2Size > 0;
+            return this->m_hasKey;
+        }
+        
+    private:
+        bn::BignumPtr m_v = bn::New();
+        bn::BignumPtr m_b = bn::New();
+        bn::BignumPtr m_kv = bn::New();
+        Digest m_M1Prefix;
+        bool m_started = false;
+    };
+}
@@ -25,20 +25,147 @@
 #include <simplesrp/details.h>
 
 #include <openssl/bn.h>
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 namespace simplesrp::bn {
     using BignumPtr = std::shared_ptr<BIGNUM>;
     using BignumCPtr = std::shared_ptr<const BIGNUM>;
+    using ContextPtr = std::unique_ptr<BN_CTX, decltype(&BN_CTX_free)>;
+    using MontContextPtr = std::shared_ptr<const BN_MONT_CTX>;
     
     BignumPtr Own(BIGNUM* bn);
     BignumPtr New();
     BignumPtr Random(size_t size);
+    BignumPtr RandomBits(size_t bits);
+    
+    /// Fills `r` with random number of exactly `bits` bits (top bit set) from `utils::RandomBytes`, like BN_rand does.
+    /// Does not allocate memory for numbers up to 8192 bits once `r` has grown to that size.
+    bool RandomBits(BIGNUM* r, size_t bits);
     BignumPtr FromBytes(const Buffer& data);
     BignumPtr FromBytes(const void* ptr, size_t size);
     
     Buffer ToBytes(const BIGNUM* bn, size_t minSize = 0);
     Buffer ToBytes(BignumCPtr bn, size_t minSize = 0);
     
-    std::unique_ptr<BN_CTX, decltype(&BN_CTX_free)> MakeContext();
+    ContextPtr MakeContext();
+    
+    /// Returns BN_CTX owned by the calling thread. It is reused by all calls made on that thread
+    /// and freed when the thread exits. Do not pass it to other threads.
+    BN_CTX* ThreadContext();
+    
+    /// Creates Montgomery context for odd modulus `m`. The context is read-only after creation
+    /// and may be shared between threads.
+    MontContextPtr MakeMontContext(const BIGNUM* m);
+    
+    /// Modular arithmetic of SRP, implemented by the backend chosen at build time with the
+    /// SIMPLESRP_BN_BACKEND option: OpenSSL (src/bn_openssl.cpp) or GMP (src/bn_gmp.cpp).
+    /// Numbers are BIGNUMs at this interface whatever the backend; m is odd and positive.
+    
+    /// Name of the backend, e.g. for benchmark reports.
+    const char* BackendName();
+    
+    /// r = a^p mod m. `mont` is the precomputed Montgomery context of `m`, used by OpenSSL only.
+    bool ModExp(BIGNUM* r, const BIGNUM* a, const BIGNUM* p, const BIGNUM* m, const BN_MONT_CTX* mont, BN_CTX* ctx);
+    
+    /// r = a * b mod m, r = a + b mod m, r = a - b mod m, r = a mod m; results are in [0, m).
+    bool ModMul(BIGNUM* r, const BIGNUM* a, const BIGNUM* b, const BIGNUM* m, BN_CTX* ctx);
+    bool ModAdd(BIGNUM* r, const BIGNUM* a, const BIGNUM* b, const BIGNUM* m, BN_CTX* ctx);
+    bool ModSub(BIGNUM* r, const BIGNUM* a, const BIGNUM* b, const BIGNUM* m, BN_CTX* ctx);
+    bool Mod(BIGNUM* r, const BIGNUM* a, const BIGNUM* m, BN_CTX* ctx);
+    
+    /// Returns -1, 0 or 1 as `a` is less than, equal to or greater than `b`.
+    int Compare(const BIGNUM* a, const BIGNUM* b);
+    
+    /// Precomputed table for exponentiation of fixed base `g` modulo `m` (Lim-Lee comb).
+    /// The table keeps 2^teeth numbers of `m` size and turns g^e into about maxBits/teeth
+    /// squarings and multiplications. Entries are selected by scanning the whole table and every column
+    /// is multiplied, so memory access and operation count do not depend on exponent bits.
+    /// Read-only after construction, may be shared between threads.
+    /// Tables with zero or more than `MaxTeeth` teeth are left empty and pass everything to `ModExp`.
+    class FixedBaseTable {
+    public:
+        static constexpr size_t MaxTeeth = 10;
+        
+        FixedBaseTable(const BIGNUM* g, const BIGNUM* m, MontContextPtr mont, size_t maxBits, size_t teeth);
+        
+        /// r = g^e mod m. Exponents that does not benefit from the table are passed to `ModExp`.
+        bool exp(BIGNUM* r, const BIGNUM* e, BN_CTX* ctx) const;
+        
+        size_t maxBits() const { return m_maxBits; }
+        size_t teeth() const { return m_teeth; }
+        
+    private:
+        /// entry = table[idx] in constant time, `words` is scratch of `m_entryWords`.
+        bool select(size_t idx, uint64_t* words, BIGNUM* entry) const;
+        
+    private:
+        const BIGNUM* m_g;
+        const BIGNUM* m_m;
+        MontContextPtr m_mont;
+        size_t m_maxBits;
+        size_t m_teeth;
+        size_t m_spacing;
+        size_t m_entryWords;
+        std::vector<uint64_t> m_table;
+    };
+    
+    /// Powers g^(2^(i * chunkBits)) that split exponentiation of fixed base `g` modulo `m` into
+    /// independent chunks: g^e is the product of (g^(2^(i * chunkBits)))^e_i over `chunks` pieces e_i
+    /// of e, so pieces may be computed on different threads. Read-only after construction.
+    class ChunkedBaseTable {
+    public:
+        ChunkedBaseTable(const BIGNUM* g, const BIGNUM* m, MontContextPtr mont, size_t maxBits, size_t chunks);
+        
+        /// r = (g^(2^(i * chunkBits)))^e_i mod m, where e_i are bits [i * chunkBits, (i + 1) * chunkBits) of `e`.
+        /// `e` must not be negative or longer than `maxBits`.
+        bool exp(BIGNUM* r, size_t i, const BIGNUM* e, BN_CTX* ctx) const;
+        
+        size_t chunks() const { return m_bases.size(); }
+        size_t chunkBits() const { return m_chunkBits; }
+        
+    private:
+        const BIGNUM* m_m;
+        MontContextPtr m_mont;
+        size_t m_chunkBits;
+        std::vector<BignumPtr> m_bases;
+    };
+    
+    /// Instruction set used by `MontKernel`.
+    enum class MontKernelPath {
+        /// `ModExp` of the bignum backend, OpenSSL by default.
+        OpenSSL,
+        
+        /// Montgomery multiplication in 52-bit limbs with AVX-512 IFMA, 8 limbs per instruction.
+        AVX512IFMA,
+    };
+    
+    /// Native exponentiation modulo `m` of one of the SRP group sizes (1024-8192 bits).
+    /// Exponents are processed in fixed windows with constant-time table lookups.
+    /// Other moduli and CPUs without the instruction set use `ModExp`.
+    /// Read-only after construction, may be shared between threads.
+    class MontKernel {
+    public:
+        /// Uses `path` if the CPU and the size of `m` support it, otherwise `MontKernelPath::OpenSSL`.
+        MontKernel(const BIGNUM* m, MontContextPtr mont, MontKernelPath path);
+        
+        MontKernelPath path() const { return m_path; }
+        
+        /// r = a^p mod m.
+        bool exp(BIGNUM* r, const BIGNUM* a, const BIGNUM* p, BN_CTX* ctx) const;
+        
+        /// Fastest path supported by this CPU and build.
+        static MontKernelPath SupportedPath();
+        
+    private:
+        const BIGNUM* m_m;
+        MontContextPtr m_mont;
+        MontKernelPath m_path;
+        size_t m_limbs = 0;
+        size_t m_vectors = 0;
+        uint64_t m_k0 = 0;
+        std::vector<uint64_t> m_m52;
+        std::vector<uint64_t> m_rr52;
+    };
 }
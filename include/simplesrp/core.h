@@ -0,0 +1,181 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#pragma once
+
+#include <simplesrp/details.h>
+#include <simplesrp/group.h>
+#include <simplesrp/routines.h>
+
+#include <algorithm>
+
+/// Building blocks of SRP-6a computations that write into caller-provided storage.
+/// Once BIGNUMs and BN_CTX are warmed up, none of these functions allocate memory.
+///
+/// `scratch` must hold at least `group.bignumSize` bytes.
+/// Digest outputs (`x`, `u`, `K`, `M1`, `M2`) are `DigestSize(group.digestType)` bytes;
+/// wherever they are hashed again, leading zero bytes are skipped as `bn::ToBytes` does.
+namespace simplesrp::core {
+    /// Shortest private ephemeral exponent accepted in bits.
+    constexpr size_t MinEphemeralBits = 256;
+    
+    /// Length of private ephemeral exponents for `params` in bits: `params.ephemeralBits`
+    /// clamped to `MinEphemeralBits`..size of N, or size of N when it is zero.
+    size_t EphemeralBits(const SRPParams& params);
+    
+    /// True if `routines.calculate_x` is the built-in one, so batch paths may compute x themselves.
+    bool IsBuiltIn_x(const SRPRoutines& routines);
+    
+    /// True if all routines of `SRPServer::verifySession` are built-in, so batch paths may replace them.
+    bool IsBuiltInServerVerification(const SRPRoutines& routines);
+    
+    /// Writes `data` without leading zero bytes into `out`. Returns written size or zero if `outSize` is too small.
+    size_t CopyStripped(const uint8_t* data, size_t size, uint8_t* out, size_t outSize);
+    
+    /// Compares values ignoring leading zero bytes, in constant time for equal lengths.
+    bool EqualStripped(const uint8_t* lhs, size_t lhsSize, const uint8_t* rhs, size_t rhsSize);
+    
+    /// Exponentiations below go through `kernel` when it is given, otherwise through `bn::ModExp`.
+    
+    bool Calculate_A(const SRPGroup& group, const BIGNUM* a, BIGNUM* A, BN_CTX* ctx, const bn::MontKernel* kernel = nullptr);
+    bool Combine_B(const SRPGroup& group, const BIGNUM* gb, const BIGNUM* v, const BIGNUM* k, BIGNUM* B, BN_CTX* ctx);
+    
+    /// kv = k*v mod N, constant per verifier.
+    bool Calculate_kv(const SRPGroup& group, const BIGNUM* k, const BIGNUM* v, BIGNUM* kv, BN_CTX* ctx);
+    
+    /// B = kv + g^b with precomputed `kv`.
+    bool CombineKV_B(const SRPGroup& group, const BIGNUM* gb, const BIGNUM* kv, BIGNUM* B, BN_CTX* ctx);
+    
+    /// S = (B - k*(g^x)) ^ (a + ux)
+    bool ClientPremaster(const SRPGroup& group, const BIGNUM* u, const BIGNUM* x, const BIGNUM* k,
+                         const BIGNUM* a, const BIGNUM* B, BIGNUM* S, BN_CTX* ctx,
+                         const bn::MontKernel* kernel = nullptr);
+    
+    /// S = (A * (v^u)) ^ b
+    bool ServerPremaster(const SRPGroup& group, const BIGNUM* u, const BIGNUM* v,
+                         const BIGNUM* b, const BIGNUM* A, BIGNUM* S, BN_CTX* ctx,
+                         const bn::MontKernel* kernel = nullptr);
+    
+    bool ClientSafetyCheck(const BIGNUM* B, const BIGNUM* u);
+    bool ServerSafetyCheck(const SRPGroup& group, const BIGNUM* A, BN_CTX* ctx);
+    
+    /// Hashing steps are templates over the digest so that `utils::StaticDigest` may be used
+    /// instead of `utils::Digest`. The digest is constructed from `group.digestType`.
+    
+    /// Number of bytes a bignum is padded to before hashing, or zero when `flag` asks to skip zeroes.
+    inline size_t HashedBignumSize(const SRPGroup& group, Flags flag) {
+        return (group.flags & flag) ? 0 : group.bignumSize;
+    }
+    
+    /// Hashes `bn` as big-endian bytes, left-padded with zeroes to `minSize`.
+    template <class Digest>
+    void UpdateBignum(Digest& di, const BIGNUM* bn, size_t minSize, uint8_t* scratch) {
+        const size_t size = std::max(minSize, static_cast<size_t>(BN_num_bytes(bn)));
+        BN_bn2binpad(bn, scratch, static_cast<int>(size));
+        di.update(scratch, size);
+    }
+    
+    /// Hashes bytes skipping leading zero bytes.
+    template <class Digest>
+    void UpdateStripped(Digest& di, const uint8_t* data, size_t size) {
+        while (size > 0 && *data == 0) {
+            data++;
+            size--;
+        }
+        di.update(data, size);
+    }
+    
+    template <class Digest = utils::Digest>
+    void Calculate_x(const SRPGroup& group,
+                     const void* username, size_t usernameSize,
+                     const void* password, size_t passwordSize,
+                     const void* salt, size_t saltSize, uint8_t* x) {
+        Digest di(group.digestType);
+        if (!(group.flags & SRPFlagNoUsernameInX)) {
+            di.update(username, usernameSize);
+        }
+        di.update(":", 1);
+        di.update(password, passwordSize);
+        di.final(x);
+        
+        Digest di_x(group.digestType);
+        di_x.update(salt, saltSize);
+        di_x.update(x, di_x.hashSize());
+        di_x.final(x);
+    }
+    
+    template <class Digest = utils::Digest>
+    void Calculate_u(const SRPGroup& group, const BIGNUM* A, const BIGNUM* B, uint8_t* scratch, uint8_t* u) {
+        const size_t bnSize = HashedBignumSize(group, SRPFlagSkipZeroes_k_U_X);
+        Digest di(group.digestType);
+        UpdateBignum(di, A, bnSize, scratch);
+        UpdateBignum(di, B, bnSize, scratch);
+        di.final(u);
+    }
+    
+    /// K = H(S)
+    template <class Digest = utils::Digest>
+    void Calculate_K(const SRPGroup& group, const BIGNUM* S, uint8_t* scratch, uint8_t* K) {
+        Digest di(group.digestType);
+        UpdateBignum(di, S, 0, scratch);
+        di.final(K);
+    }
+    
+    /// M1 = H(H(N) xor H(g) | H(I) | s | A | B | K), split so the prefix known before A
+    /// arrives may be hashed early and kept as digest state.
+    template <class Digest = utils::Digest>
+    Digest BeginM1(const SRPGroup& group, const void* username, size_t usernameSize, const void* salt, size_t saltSize) {
+        uint8_t hashI[SHA512_DIGEST_LENGTH];
+        Digest di_I(group.digestType);
+        di_I.update(username, usernameSize);
+        di_I.final(hashI);
+        
+        Digest di(group.digestType);
+        di.update(group.hashXor.data(), group.hashXor.size());
+        di.update(hashI, di.hashSize());
+        di.update(salt, saltSize);
+        return di;
+    }
+    
+    template <class Digest>
+    void FinishM1(const SRPGroup& group, Digest& di, const BIGNUM* A, const BIGNUM* B,
+                  const uint8_t* K, size_t KSize, uint8_t* scratch, uint8_t* M1) {
+        const size_t bnSize = HashedBignumSize(group, SRPFlagSkipZeroes_M1_M2);
+        UpdateBignum(di, A, bnSize, scratch);
+        UpdateBignum(di, B, bnSize, scratch);
+        UpdateStripped(di, K, KSize);
+        di.final(M1);
+    }
+    
+    /// M2 = H(A | M1 | K)
+    template <class Digest = utils::Digest>
+    void Calculate_M2(const SRPGroup& group, const BIGNUM* A, const uint8_t* M1, size_t M1Size,
+                      const uint8_t* K, size_t KSize, uint8_t* scratch, uint8_t* M2) {
+        const size_t bnSize = HashedBignumSize(group, SRPFlagSkipZeroes_M1_M2);
+        Digest di(group.digestType);
+        UpdateBignum(di, A, bnSize, scratch);
+        UpdateStripped(di, M1, M1Size);
+        UpdateStripped(di, K, KSize);
+        di.final(M2);
+    }
+}
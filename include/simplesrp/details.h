@@ -30,6 +30,25 @@
 #include <string>
 #include <vector>
 
+#if defined(_MSC_VER)
+#define SSRP_DISABLE_DEPRECATION_WARNINGS \
+    __pragma(warning(push)) \
+    __pragma(warning(disable : 4996))
+#define SSRP_ENABLE_DEPRECATION_WARNINGS \
+    __pragma(warning(pop))
+
+#elif defined(__GNUC__) || defined(__clang__)
+#define SSRP_DISABLE_DEPRECATION_WARNINGS \
+    _Pragma("GCC diagnostic push") \
+    _Pragma("GCC diagnostic ignored \"-Wdeprecated-declarations\"")
+#define SSRP_ENABLE_DEPRECATION_WARNINGS \
+    _Pragma("GCC diagnostic pop")
+
+#else
+#define SSRP_DISABLE_DEPRECATION_WARNINGS
+#define SSRP_ENABLE_DEPRECATION_WARNINGS
+#endif
+
 namespace simplesrp {
     using Buffer = std::vector<uint8_t>;
     
@@ -51,6 +70,32 @@ namespace simplesrp {
         SHA512,
     };
     
+    /// Size of N in bytes.
+    constexpr size_t BignumSize(SRPBits bits) {
+        switch (bits) {
+        case SRPBits::Key1024: return 128;
+        case SRPBits::Key1536: return 192;
+        case SRPBits::Key2048: return 256;
+        case SRPBits::Key3072: return 384;
+        case SRPBits::Key4096: return 512;
+        case SRPBits::Key6144: return 768;
+        case SRPBits::Key8192: return 1024;
+        default: return 0;
+        }
+    }
+    
+    /// Size of digest output in bytes.
+    constexpr size_t DigestSize(DigestType digestType) {
+        switch (digestType) {
+        case DigestType::SHA1: return 20;
+        case DigestType::SHA224: return 28;
+        case DigestType::SHA256: return 32;
+        case DigestType::SHA384: return 48;
+        case DigestType::SHA512: return 64;
+        default: return 0;
+        }
+    }
+    
     enum Flags {
         // Shared secret will be calculated without username, but rest calculations uses original username.
         SRPFlagNoUsernameInX = 1 << 0,
@@ -83,9 +128,18 @@ namespace simplesrp {
         return lhs;
     }
     
+    struct SRPGroup;
+    
     struct SRPParams {
         const SRP_gN* gn;
         DigestType digestType;
         Flags flags = {};
+        
+        /// Length of private ephemeral exponents `a` and `b` in bits. Zero means size of N.
+        /// RFC 5054 allows shorter exponents; values are clamped to 256..size of N bits.
+        size_t ephemeralBits = 0;
+        
+        /// Cached per-group constants. Used only while it matches `gn`, `digestType` and `flags`.
+        const SRPGroup* group = nullptr;
     };
 }
@@ -0,0 +1,64 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#pragma once
+
+#include <simplesrp/simplesrp.h>
+#include <simplesrp/threadpool.h>
+
+namespace simplesrp {
+    /// Runs `SRPServer` handshake steps on its own worker threads.
+    /// Each worker uses its own BN_CTX. Completions are called on worker threads.
+    ///
+    /// The queue of pending jobs is bounded: when it is full, submitting methods
+    /// return false immediately and the job is not scheduled.
+    class SRPServerEngine {
+    public:
+        using StartCompletion = std::function<void(const Buffer& B)>;
+        using VerifyCompletion = std::function<void(bool verified, const Buffer& M2)>;
+        
+        /// Zero `threadCount` means number of hardware threads.
+        /// `queueCapacity` is the number of jobs that may wait for a worker, at least one.
+        SRPServerEngine(size_t threadCount, size_t queueCapacity);
+        
+        /// Waits until all scheduled jobs are complete.
+        ~SRPServerEngine();
+        
+        /// Schedules `server->startAuthentication`.
+        bool startAuthentication(std::shared_ptr<SRPServer> server,
+                                 std::string username, Buffer salt, Buffer verifier,
+                                 StartCompletion completion);
+        
+        /// Schedules `server->verifySession`.
+        bool verifySession(std::shared_ptr<SRPServer> server, Buffer A, Buffer M1,
+                           VerifyCompletion completion);
+        
+        size_t threadCount() const;
+        
+        /// Number of jobs waiting for a free worker.
+        size_t pendingCount() const;
+        
+    private:
+        utils::ThreadPool m_pool;
+    };
+}
@@ -0,0 +1,79 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#pragma once
+
+#include <simplesrp/details.h>
+#include <simplesrp/bn.h>
+
+namespace simplesrp {
+    /// Immutable constants that depend only on (N, g, DigestType, Flags).
+    /// Instances are created once per combination and live until the process exits.
+    struct SRPGroup {
+        const SRP_gN* gn = nullptr;
+        DigestType digestType = DigestType::SHA1;
+        Flags flags = {};
+        
+        /// Size of N in bytes.
+        size_t bignumSize = 0;
+        
+        /// N and g left-padded with zeroes to `bignumSize`.
+        Buffer paddedN;
+        Buffer paddedG;
+        
+        /// k = H(N | PAD(g)).
+        bn::BignumCPtr k;
+        
+        /// H(N) xor H(g), the prefix of M1.
+        Buffer hashXor;
+        
+        /// Montgomery context of N. Shared by all groups of the same `gn`, it also keys the caches below.
+        bn::MontContextPtr mont;
+        
+        /// Returns table for fixed-base exponentiation of g for exponents up to `maxBits`.
+        /// The table is built on first request and shared by all groups with the same N. Thread-safe.
+        std::shared_ptr<const bn::FixedBaseTable> fixedBaseTable(size_t maxBits, size_t teeth) const;
+        
+        /// Returns table splitting g^e into `chunks` independent exponentiations for exponents up to `maxBits`.
+        /// The table is built on first request and shared by all groups with the same N. Thread-safe.
+        std::shared_ptr<const bn::ChunkedBaseTable> chunkedBaseTable(size_t maxBits, size_t chunks) const;
+        
+        /// Returns native exponentiation kernel of N for `path`.
+        /// The kernel is built on first request and shared by all groups with the same N. Thread-safe.
+        std::shared_ptr<const bn::MontKernel> montKernel(bn::MontKernelPath path) const;
+        
+        bool matches(const SRP_gN* gn, DigestType digestType, Flags flags) const;
+        
+        /// Returns shared group for given combination, nullptr if `gn` is null. Thread-safe.
+        /// Groups are keyed by `gn` and rebuilt if N or g at that address changed.
+        static const SRPGroup* Get(const SRP_gN* gn, DigestType digestType, Flags flags);
+        
+        /// Returns `params.group` if it is still valid for `params`, otherwise looks up the registry.
+        /// `params.gn` must be set (`SRPRoutines::gN` returns null for unknown `SRPBits`): the process
+        /// is aborted otherwise rather than dereferencing null.
+        static const SRPGroup& Get(const SRPParams& params);
+    };
+    
+    /// Parameters for `digestType` and `srpBits` with `SRPParams::group` already resolved.
+    SRPParams CreateParams(DigestType digestType, SRPBits srpBits);
+}
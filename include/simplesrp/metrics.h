@@ -0,0 +1,101 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace simplesrp {
+    /// Plain copy of `SRPMetrics` counters.
+    struct SRPMetricsSnapshot {
+        struct Routine {
+            uint64_t calls = 0;
+            uint64_t nanoseconds = 0;
+        };
+        
+        Routine randomBN;
+        Routine calculate_A;
+        Routine calculate_B;
+        Routine combine_B;
+        Routine combineKV_B;
+        Routine calculate_k;
+        Routine calculate_x;
+        Routine calculate_u;
+        Routine calculateClient_K;
+        Routine calculateServer_K;
+        Routine calculate_M1;
+        Routine calculate_M2;
+        Routine clientSafetyCheck;
+        Routine serverSafetyCheck;
+        
+        /// `SRPServer::verifySession` calls rejected by `serverSafetyCheck`.
+        uint64_t failedSafetyChecks = 0;
+        
+        /// `SRPServer::verifySession` calls with wrong client proof.
+        uint64_t M1Mismatches = 0;
+    };
+    
+    /// Thread-safe counters of SRP computations. Enable with `SRPRoutines::useMetrics`
+    /// and `SRPServer::metrics`; nothing is measured otherwise.
+    class SRPMetrics {
+    public:
+        /// Indexes of routines, in the order of `SRPMetricsSnapshot` fields.
+        enum Routine : size_t {
+            RandomBN,
+            Calculate_A,
+            Calculate_B,
+            Combine_B,
+            CombineKV_B,
+            Calculate_k,
+            Calculate_x,
+            Calculate_u,
+            CalculateClient_K,
+            CalculateServer_K,
+            Calculate_M1,
+            Calculate_M2,
+            ClientSafetyCheck,
+            ServerSafetyCheck,
+            RoutineCount,
+        };
+        
+        void record(Routine routine, std::chrono::nanoseconds duration);
+        void recordFailedSafetyCheck();
+        void recordM1Mismatch();
+        
+        SRPMetricsSnapshot snapshot() const;
+        void reset();
+        
+    private:
+        struct Counter {
+            std::atomic<uint64_t> calls{0};
+            std::atomic<uint64_t> nanoseconds{0};
+        };
+        
+        std::array<Counter, RoutineCount> m_routines;
+        std::atomic<uint64_t> m_failedSafetyChecks{0};
+        std::atomic<uint64_t> m_M1Mismatches{0};
+    };
+}
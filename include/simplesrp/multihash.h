@@ -0,0 +1,68 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#pragma once
+
+#include <simplesrp/details.h>
+
+namespace simplesrp::utils {
+    /// Instruction set used by `MultiDigest`.
+    enum class MultiDigestPath {
+        /// One message at a time through `Digest`.
+        Scalar,
+        
+        /// 8 messages of SHA1/SHA224/SHA256 or 4 of SHA384/SHA512 per step.
+        AVX2,
+        
+        /// 16 messages of SHA1/SHA224/SHA256 or 8 of SHA384/SHA512 per step.
+        AVX512,
+    };
+    
+    /// Hashes many independent messages at once, one message per SIMD lane.
+    /// Lanes are refilled as soon as their message is done, so messages may have different lengths.
+    /// Results are identical to `Digest` on every path.
+    class MultiDigest {
+    public:
+        /// Uses the fastest path for the CPU. AVX2 is skipped for SHA1/SHA224/SHA256
+        /// when the CPU has SHA extensions: OpenSSL is faster there.
+        explicit MultiDigest(DigestType digestType);
+        
+        /// Uses `path` if the CPU supports it, otherwise the fastest supported path below it.
+        MultiDigest(DigestType digestType, MultiDigestPath path);
+        
+        MultiDigestPath path() const;
+        
+        /// Number of messages hashed in parallel.
+        size_t lanes() const;
+        
+        /// Writes `DigestSize(digestType)` bytes of hash of `data[i]` (`sizes[i]` bytes) into `hashes[i]`.
+        void hash(size_t count, const uint8_t* const* data, const size_t* sizes, uint8_t* const* hashes) const;
+        
+        /// Fastest path supported by this CPU and build.
+        static MultiDigestPath SupportedPath();
+        
+    private:
+        DigestType m_digestType;
+        MultiDigestPath m_path;
+    };
+}
@@ -0,0 +1,75 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#pragma once
+
+#include <simplesrp/details.h>
+#include <simplesrp/routines.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace simplesrp {
+    /// Pool of precomputed server ephemeral pairs (b, g^b) for one set of parameters.
+    /// Background thread refills the pool up to `highWatermark` once it drops below `lowWatermark`.
+    /// Share single pool between `SRPServer` instances via `SRPServer::ephemeralPool`.
+    class SRPEphemeralPool {
+    public:
+        SRPEphemeralPool(const SRPParams& params, const SRPRoutines& routines,
+                         size_t lowWatermark, size_t highWatermark);
+        ~SRPEphemeralPool();
+        
+        SRPEphemeralPool(const SRPEphemeralPool&) = delete;
+        SRPEphemeralPool& operator=(const SRPEphemeralPool&) = delete;
+        
+        /// Fills the pool up to `highWatermark` on calling thread.
+        void prefill();
+        
+        /// Takes precomputed pair if the pool is not empty.
+        bool take(bn::BignumPtr& b, bn::BignumPtr& gb);
+        
+        /// True if pairs of the pool are usable with `params`.
+        bool matches(const SRPParams& params) const;
+        
+        size_t size() const;
+        
+    private:
+        std::pair<bn::BignumPtr, bn::BignumPtr> generate() const;
+        void refill();
+        
+    private:
+        const SRPParams m_params;
+        const SRPRoutines m_routines;
+        const size_t m_lowWatermark;
+        const size_t m_highWatermark;
+        
+        std::deque<std::pair<bn::BignumPtr, bn::BignumPtr>> m_pairs;
+        mutable std::mutex m_lock;
+        std::condition_variable m_cv;
+        bool m_stop = false;
+        std::thread m_thread;
+    };
+}
@@ -0,0 +1,41 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace simplesrp::utils {
+    /// Output of the per-thread DRBG after which it is reseeded from the system source, in bytes.
+    constexpr size_t RandomReseedInterval = 1 << 20;
+    
+    /// Fills `ptr` with `size` bytes from the calling thread's DRBG: ChaCha20 keystream with
+    /// fast key erasure, seeded from `RAND_priv_bytes` and refilled in bulk, so most calls
+    /// take no locks and make no system calls. The DRBG is reseeded after
+    /// `RandomReseedInterval` bytes and in a child process after `fork`.
+    /// Returns false only if seeding fails.
+    bool RandomBytes(void* ptr, size_t size);
+    
+    /// Makes the calling thread's DRBG reseed from the system source on next use.
+    void ReseedRandom();
+}
@@ -0,0 +1,148 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#pragma once
+
+#include <simplesrp/details.h>
+#include <simplesrp/routines.h>
+#include <simplesrp/wire.h>
+
+namespace simplesrp {
+    /// SRP client working on caller-provided buffers.
+    /// Numbers are allocated once per instance and reused, so repeated handshakes on the same
+    /// instance do not allocate heap memory. Always uses built-in SRP-6a computations:
+    /// customization through `SRPRoutines` is not available here.
+    ///
+    /// Public values (A, B) are written left-padded to `bignumSize()` bytes.
+    /// Proofs and session key are written without leading zero bytes, exactly as `SRPClient` produces them;
+    /// buffers of `digestSize()` bytes are always enough. Size arguments passed by reference are
+    /// buffer capacity on input and number of written bytes on output.
+    class SRPRawClient {
+    public:
+        SRPRawClient(DigestType digestType, SRPBits srpBits);
+        
+        SRPRawClient(const SRPRawClient&) = delete;
+        SRPRawClient& operator=(const SRPRawClient&) = delete;
+        
+        SRPParams params;
+        
+        size_t bignumSize() const;
+        size_t digestSize() const;
+        
+        bool startAuthentication(uint8_t* A, size_t ASize);
+        bool processChallenge(const char* username, size_t usernameSize,
+                              const char* password, size_t passwordSize,
+                              const uint8_t* salt, size_t saltSize,
+                              const uint8_t* B, size_t BSize,
+                              uint8_t* M1, size_t& M1Size);
+        bool verifySession(const uint8_t* M2, size_t M2Size) const;
+        
+        /// Same as above on messages decoded by `SRPWireCodec`.
+        bool processChallenge(const char* username, size_t usernameSize,
+                              const char* password, size_t passwordSize,
+                              const SRPServerChallengeView& challenge,
+                              uint8_t* M1, size_t& M1Size);
+        bool verifySession(const SRPProofView& M2) const;
+        
+        /// Returns number of written bytes, zero if session is not established or `KSize` is too small.
+        size_t sessionKey(uint8_t* K, size_t KSize) const;
+        
+        /// Alternative version that accept private portion of exchange data.
+        /// Using weak or hardcoded private data may break the security of the app.
+        bool insecure_startAuthentication(const uint8_t* a, size_t aSize, uint8_t* A, size_t ASize);
+        
+    private:
+        uint8_t* scratch();
+        
+    private:
+        bn::BignumPtr m_a;
+        bn::BignumPtr m_A;
+        bn::BignumPtr m_B;
+        bn::BignumPtr m_u;
+        bn::BignumPtr m_x;
+        bn::BignumPtr m_S;
+        Buffer m_scratch;
+        uint8_t m_K[SHA512_DIGEST_LENGTH] = {};
+        uint8_t m_M2[SHA512_DIGEST_LENGTH] = {};
+        bool m_hasKey = false;
+    };
+    
+    /// SRP server working on caller-provided buffers. See `SRPRawClient` for buffer conventions.
+    class SRPRawServer {
+    public:
+        SRPRawServer(DigestType digestType, SRPBits srpBits);
+        
+        SRPRawServer(const SRPRawServer&) = delete;
+        SRPRawServer& operator=(const SRPRawServer&) = delete;
+        
+        SRPParams params;
+        
+        size_t bignumSize() const;
+        size_t digestSize() const;
+        
+        bool startAuthentication(const char* username, size_t usernameSize,
+                                 const uint8_t* salt, size_t saltSize,
+                                 const uint8_t* verifier, size_t verifierSize,
+                                 uint8_t* B, size_t BSize);
+        
+        /// Same as above with precomputed `kv` = k*v mod N, see `SRPVerifierGenerator::generateKV`.
+        /// Fails if `kv` is not less than N.
+        bool startAuthentication(const char* username, size_t usernameSize,
+                                 const uint8_t* salt, size_t saltSize,
+                                 const uint8_t* verifier, size_t verifierSize,
+                                 const uint8_t* kv, size_t kvSize,
+                                 uint8_t* B, size_t BSize);
+        
+        bool verifySession(const uint8_t* A, size_t ASize,
+                           const uint8_t* M1, size_t M1Size,
+                           uint8_t* M2, size_t& M2Size);
+        
+        /// Same as above on messages decoded by `SRPWireCodec`; `A` is the one of the client hello
+        /// the session was started with.
+        bool startAuthentication(const SRPClientHelloView& hello,
+                                 const uint8_t* salt, size_t saltSize,
+                                 const uint8_t* verifier, size_t verifierSize,
+                                 uint8_t* B, size_t BSize);
+        bool verifySession(SRPBytesView A, const SRPProofView& M1, uint8_t* M2, size_t& M2Size);
+        
+        /// Returns number of written bytes, zero if session is not established or `KSize` is too small.
+        size_t sessionKey(uint8_t* K, size_t KSize) const;
+        
+    private:
+        uint8_t* scratch();
+        
+    private:
+        bn::BignumPtr m_v;
+        bn::BignumPtr m_b;
+        bn::BignumPtr m_B;
+        bn::BignumPtr m_A;
+        bn::BignumPtr m_u;
+        bn::BignumPtr m_S;
+        bn::BignumPtr m_kv;
+        Buffer m_scratch;
+        utils::Digest m_M1Prefix;
+        uint8_t m_K[SHA512_DIGEST_LENGTH] = {};
+        bool m_started = false;
+        bool m_hasKey = false;
+    };
+}
@@ -26,12 +26,20 @@
 #include <simplesrp/bn.h>
 
 namespace simplesrp {
+    class SRPMetrics;
+    
+    namespace utils {
+        class ThreadPool;
+    }
+    
     struct SRPRoutines {
         SRPRoutines();
         
         std::function<bn::BignumPtr(const SRPParams& params)> randomBN;
         std::function<bn::BignumPtr(const SRPParams& params, const BIGNUM* a)> calculate_A;
         std::function<bn::BignumPtr(const SRPParams& params, const BIGNUM* b, const BIGNUM* v, const BIGNUM* k)> calculate_B;
+        std::function<bn::BignumPtr(const SRPParams& params, const BIGNUM* gb, const BIGNUM* v, const BIGNUM* k)> combine_B;
+        std::function<bn::BignumPtr(const SRPParams& params, const BIGNUM* gb, const BIGNUM* kv)> combineKV_B;
         std::function<bn::BignumPtr(const SRPParams& params)> calculate_k;
         std::function<bn::BignumPtr(const SRPParams& params, const std::string& username, const std::string& password, const Buffer& salt)> calculate_x;
         std::function<bn::BignumPtr(const SRPParams& params, const BIGNUM* A, const BIGNUM* B)> calculate_u;
@@ -43,6 +51,27 @@ namespace simplesrp {
         std::function<bool(const SRPParams& params, const BIGNUM* B, const BIGNUM* u)> clientSafetyCheck;
         std::function<bool(const SRPParams& params, const BIGNUM* A)> serverSafetyCheck;
         
+        /// Switches `calculate_A` and `calculate_B` to fixed-base exponentiation of g.
+        /// Tables are built lazily per N and take 2^combTeeth numbers of N size each:
+        /// more teeth means more memory and faster exponentiation. `combTeeth` is clamped
+        /// to 1..`bn::FixedBaseTable::MaxTeeth` (10).
+        void useFixedBaseExponentiation(size_t combTeeth = 6);
+        
+        /// Switches `calculate_A`, `calculate_B`, `calculateClient_K` and `calculateServer_K` to
+        /// `bn::MontKernel` of N for `path`, falling back to OpenSSL where it is not supported.
+        /// Call before `useFixedBaseExponentiation` to keep comb tables for powers of g.
+        void useNativeExponentiation(bn::MontKernelPath path = bn::MontKernel::SupportedPath());
+        
+        /// Switches `calculate_A` and `calculate_B` to split g^e into `chunks` exponentiations run
+        /// concurrently on `pool` (k*v of B is one more task), cutting latency of a single handshake
+        /// on large groups. Zero `chunks` means the pool's thread count. The pool must not be the one
+        /// running handshakes: its threads would wait for themselves.
+        void useParallelExponentiation(std::shared_ptr<utils::ThreadPool> pool, size_t chunks = 0);
+        
+        /// Wraps every routine currently set to count calls and time into `metrics`.
+        /// Call after other customizations, otherwise replaced routines are not measured.
+        void useMetrics(std::shared_ptr<SRPMetrics> metrics);
+        
         static std::function<const SRP_gN*(SRPBits bits)> gN;
     };
     
@@ -55,6 +84,9 @@ namespace simplesrp {
             void update(const Buffer& buffer);
             Buffer final();
             
+            /// Writes `hashSize()` bytes into `hash`.
+            void final(uint8_t* hash);
+            
             Buffer hash(std::initializer_list<Buffer> buffers) const;
             Buffer hash(const std::string& str) const;
             size_t hashSize() const;
@@ -0,0 +1,43 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#pragma once
+
+#include <simplesrp/details.h>
+
+namespace simplesrp::utils {
+    /// Size of the key for `Seal` and `Open` in bytes.
+    constexpr size_t SealKeySize = 32;
+    
+    /// Number of bytes `Seal` adds to the data: 12-byte nonce and 16-byte tag.
+    constexpr size_t SealOverhead = 28;
+    
+    /// Encrypts and authenticates `data` with AES-256-GCM under a fresh random nonce.
+    /// `associatedData` is authenticated but not stored: use it to tell kinds of blobs sealed with one key apart.
+    /// Returns false if the key has wrong size or encryption fails.
+    bool Seal(const Buffer& key, const uint8_t* data, size_t size, Buffer& sealed, const std::string& associatedData = {});
+    
+    /// Reverses `Seal`. Returns false if `sealed` was not produced by `Seal` with the same key
+    /// and associated data.
+    bool Open(const Buffer& key, const uint8_t* sealed, size_t size, Buffer& data, const std::string& associatedData = {});
+}
@@ -24,6 +24,12 @@
 
 #include <simplesrp/details.h>
 #include <simplesrp/routines.h>
+#include <simplesrp/metrics.h>
+#include <simplesrp/pool.h>
+#include <simplesrp/threadpool.h>
+#include <simplesrp/wire.h>
+
+#include <chrono>
 
 namespace simplesrp {
     class SRPClient {
@@ -39,17 +45,39 @@ namespace simplesrp {
                               Buffer& M1, Buffer* _M2 = nullptr);
         bool verifySession(const Buffer& M2);
         
+        /// Same as above on messages decoded by `SRPWireCodec`, without copying B and M2.
+        bool processChallenge(const std::string& username, const std::string& password,
+                              const SRPServerChallengeView& challenge, Buffer& M1);
+        bool verifySession(const SRPProofView& M2);
+        
         Buffer sessionKey() const;
         
         /// Alternative version that accept private portion of exchange data.
         /// Using weak or hardcoded private data may break the security of the app.
         void insecure_startAuthentication(const Buffer& a, Buffer& A);
         
+        /// Resumption of a session with `sessionKey()` == `K` using the server's ticket, hashing only.
+        /// Send the ticket and `clientNonce`; the server answers with its nonce.
+        /// Returns false if the nonce could not be generated.
+        bool startResumption(const Buffer& K, Buffer& clientNonce);
+        
+        /// Computes the proof of K for the server's nonce. Returns false if the nonce is malformed.
+        bool processResumption(const Buffer& serverNonce, Buffer& M1);
+        
+        /// Checks the server's proof. On success `sessionKey()` returns a fresh key derived
+        /// from the previous one and both nonces.
+        bool verifyResumption(const Buffer& M2);
+        
+    private:
+        bool processChallenge(const std::string& username, const std::string& password,
+                              const Buffer& salt, bn::BignumCPtr B, Buffer& M1, Buffer* M2);
+        
     private:
         bn::BignumPtr m_a;
         bn::BignumPtr m_A;
         bn::BignumPtr m_K;
         bn::BignumPtr m_M1;
+        Buffer m_nonces;
     };
     
     class SRPServer
@@ -60,18 +88,96 @@ namespace simplesrp {
         SRPParams params;
         SRPRoutines routines;
         
+        /// Optional source of precomputed (b, g^b) pairs. Used only if it matches `params`;
+        /// when empty, the pair is computed inline.
+        std::shared_ptr<SRPEphemeralPool> ephemeralPool;
+        
+        /// Optional sink for rejected `verifySession` calls. Routine timings are enabled
+        /// separately with `routines.useMetrics`.
+        std::shared_ptr<SRPMetrics> metrics;
+        
         void startAuthentication(const std::string& username, const Buffer& salt, const Buffer& verifier, Buffer& B);
+        
+        /// Same as above with `kv` = k*v mod N from `SRPVerifierGenerator::generateKV`,
+        /// which saves the multiplication by k. The verifier is still needed to finish the session.
+        /// Empty `kv` or one not less than N falls back to the overload above.
+        void startAuthentication(const std::string& username, const Buffer& salt, const Buffer& verifier,
+                                 const Buffer& kv, Buffer& B);
+        
         bool verifySession(const Buffer& A, const Buffer& M1, Buffer& M2);
         
+        /// Same as above on messages decoded by `SRPWireCodec`, without copying A and M1.
+        /// `A` is the one of the client hello the session was started with.
+        void startAuthentication(const SRPClientHelloView& hello, const Buffer& salt, const Buffer& verifier, Buffer& B);
+        bool verifySession(SRPBytesView A, const SRPProofView& M1, Buffer& M2);
+        
+        struct Verification {
+            SRPServer* server = nullptr;
+            Buffer A;
+            Buffer M1;
+            
+            /// Results, as `verifySession` would return them.
+            bool verified = false;
+            Buffer M2;
+        };
+        
+        /// Verifies many started sessions in one call, equivalent to `verifySession` for each item.
+        /// Hashes of all items are computed together with `utils::MultiDigest`.
+        /// Servers with customized verification routines fall back to `verifySession`.
+        /// Each server must appear once; items are processed on the calling thread.
+        static void verifySessions(Verification* items, size_t count);
+        
         Buffer sessionKey();
         
+        /// Writes the state between `startAuthentication` and `verifySession` as a versioned blob,
+        /// so that the session can be finished by another `SRPServer` with the same parameters.
+        /// The blob contains the private `b` and must not leave the servers unless sealed.
+        /// Returns false if there is no started session.
+        bool exportSession(Buffer& session) const;
+        
+        /// Same as above, sealed with `key` of `utils::SealKeySize` bytes (AES-256-GCM) and
+        /// valid for `lifetime`. The blob is meant for a single `verifySession`: sealing does not stop
+        /// replays within the lifetime, so keep it short and reject blobs already used if that matters.
+        bool exportSession(const Buffer& key, std::chrono::seconds lifetime, Buffer& session) const;
+        
+        /// Restores the state written by `exportSession`. Returns false if the blob is malformed
+        /// or was exported with other parameters; the current state is kept in that case.
+        bool importSession(const Buffer& session);
+        
+        /// Restores the state written by sealing `exportSession` with the same `key`.
+        /// Returns false if the blob has expired.
+        bool importSession(const Buffer& key, const Buffer& session);
+        
+        /// Issues a resumption ticket for the session verified last by `verifySession` or
+        /// `verifyResumption`: username and K sealed with `key` of `utils::SealKeySize` bytes,
+        /// valid for `lifetime`. Returns false if there is no verified session.
+        bool issueTicket(const Buffer& key, std::chrono::seconds lifetime, Buffer& ticket) const;
+        
+        /// Starts resumption from the client's `ticket` and nonce, returning the ticket's `username`
+        /// and the server's nonce. Returns false if the ticket was not issued with `key` and the same
+        /// parameters or has expired, or if the nonce could not be generated.
+        bool startResumption(const Buffer& key, const Buffer& ticket, const Buffer& clientNonce,
+                             std::string& username, Buffer& serverNonce);
+        
+        /// Checks the client's proof of K and returns the server's one. On success `sessionKey()`
+        /// returns the fresh key, and a new ticket may be issued for it.
+        bool verifyResumption(const Buffer& M1, Buffer& M2);
+        
     private:
+        /// Resets session state for a new authentication of `username`.
+        void beginSession(const std::string& username, const Buffer& salt, const Buffer& verifier);
+        
+        /// Takes b and g^b from `ephemeralPool` if it is set and matches `params`.
+        bool takeEphemeral(bn::BignumPtr& gb);
+        
         std::string m_username;
         Buffer m_salt;
         bn::BignumPtr m_v;
         bn::BignumPtr m_b;
         bn::BignumPtr m_B;
         bn::BignumPtr m_K;
+        bool m_verified = false;
+        Buffer m_nonces;
     };
     
     class SRPVerifierGenerator {
@@ -86,5 +192,28 @@ namespace simplesrp {
         
         void generate(const std::string& username, const std::string& password,
                       const Buffer& salt, Buffer& verifier);
+        
+        /// Computes k*v mod N for `SRPServer::startAuthentication`, left-padded to the size of N.
+        /// Store it next to the verifier: it changes only when the verifier or parameters change.
+        void generateKV(const Buffer& verifier, Buffer& kv);
+        
+        struct Record {
+            std::string username;
+            std::string password;
+            
+            /// Salt to use. When empty, random salt of `saltSize` bytes is generated and stored here.
+            Buffer salt;
+            size_t saltSize = 0;
+            
+            Buffer verifier;
+        };
+        
+        /// Fills salts and verifiers of `count` records using threads of `pool`.
+        /// Results are identical to calling `generate` for each record. Returns false if a random salt
+        /// could not be generated; such records are left with empty salt and verifier.
+        bool generate(Record* records, size_t count, utils::ThreadPool& pool);
+        
+        /// Same as above using temporary pool of `threadCount` threads (0 means number of hardware threads).
+        bool generate(std::vector<Record>& records, size_t threadCount = 0);
     };
 }
@@ -0,0 +1,145 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#   if defined(SIMPLESRP_C_BUILD)
+#       define SIMPLESRP_C_API __declspec(dllexport)
+#   else
+#       define SIMPLESRP_C_API __declspec(dllimport)
+#   endif
+#else
+#   define SIMPLESRP_C_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// C interface of the `simplesrp_c` shared library, for FFI callers.
+///
+/// Handles are opaque and owned by the caller: free them with the matching `..._free`.
+/// A handle may be used by one thread at a time. Inputs are `(pointer, size)` pairs and outputs
+/// are written into caller buffers; query their sizes with `simplesrp_bignum_size` (A, B, verifier)
+/// and `simplesrp_digest_size` (M1, M2, session key). Size arguments passed by pointer are buffer
+/// capacity on input and number of written bytes on output. Functions returning `int` return 1
+/// on success and 0 on failure. Messages are interoperable with `SRPClient`/`SRPServer`.
+
+/// Values of `SRPBits`.
+enum {
+    SIMPLESRP_BITS_1024 = 0,
+    SIMPLESRP_BITS_1536 = 1,
+    SIMPLESRP_BITS_2048 = 2,
+    SIMPLESRP_BITS_3072 = 3,
+    SIMPLESRP_BITS_4096 = 4,
+    SIMPLESRP_BITS_6144 = 5,
+    SIMPLESRP_BITS_8192 = 6,
+};
+
+/// Values of `DigestType`.
+enum {
+    SIMPLESRP_DIGEST_SHA1 = 0,
+    SIMPLESRP_DIGEST_SHA224 = 1,
+    SIMPLESRP_DIGEST_SHA256 = 2,
+    SIMPLESRP_DIGEST_SHA384 = 3,
+    SIMPLESRP_DIGEST_SHA512 = 4,
+};
+
+/// Values of `Flags`, may be combined.
+enum {
+    SIMPLESRP_FLAG_NO_USERNAME_IN_X = 1 << 0,
+    SIMPLESRP_FLAG_SKIP_ZEROES_K_U_X = 1 << 1,
+    SIMPLESRP_FLAG_SKIP_ZEROES_M1_M2 = 1 << 2,
+};
+
+typedef struct simplesrp_client simplesrp_client;
+typedef struct simplesrp_server simplesrp_server;
+typedef struct simplesrp_generator simplesrp_generator;
+
+/// Size of N in bytes, zero for unknown `bits`.
+SIMPLESRP_C_API size_t simplesrp_bignum_size(int bits);
+
+/// Size of the digest in bytes, zero for unknown `digest`.
+SIMPLESRP_C_API size_t simplesrp_digest_size(int digest);
+
+/// Fills `out` with random bytes, e.g. a salt.
+SIMPLESRP_C_API int simplesrp_random_bytes(uint8_t* out, size_t size);
+
+/// Returns NULL for unknown `bits`, `digest` or `flags`. Zero `ephemeral_bits` means the size of N.
+SIMPLESRP_C_API simplesrp_client* simplesrp_client_new(int bits, int digest, unsigned flags, size_t ephemeral_bits);
+SIMPLESRP_C_API void simplesrp_client_free(simplesrp_client* client);
+
+/// Writes A, left-padded to `simplesrp_bignum_size`.
+SIMPLESRP_C_API int simplesrp_client_start(simplesrp_client* client, uint8_t* A, size_t A_size);
+
+/// Writes M1 of up to `simplesrp_digest_size` bytes.
+SIMPLESRP_C_API int simplesrp_client_process_challenge(simplesrp_client* client,
+                                                       const char* username, size_t username_size,
+                                                       const char* password, size_t password_size,
+                                                       const uint8_t* salt, size_t salt_size,
+                                                       const uint8_t* B, size_t B_size,
+                                                       uint8_t* M1, size_t* M1_size);
+
+SIMPLESRP_C_API int simplesrp_client_verify_session(const simplesrp_client* client, const uint8_t* M2, size_t M2_size);
+
+/// Returns number of written bytes, zero if session is not established or `K_size` is too small.
+SIMPLESRP_C_API size_t simplesrp_client_session_key(const simplesrp_client* client, uint8_t* K, size_t K_size);
+
+/// Returns NULL for unknown `bits`, `digest` or `flags`. Zero `ephemeral_bits` means the size of N.
+SIMPLESRP_C_API simplesrp_server* simplesrp_server_new(int bits, int digest, unsigned flags, size_t ephemeral_bits);
+SIMPLESRP_C_API void simplesrp_server_free(simplesrp_server* server);
+
+/// Writes B, left-padded to `simplesrp_bignum_size`.
+SIMPLESRP_C_API int simplesrp_server_start(simplesrp_server* server,
+                                           const char* username, size_t username_size,
+                                           const uint8_t* salt, size_t salt_size,
+                                           const uint8_t* verifier, size_t verifier_size,
+                                           uint8_t* B, size_t B_size);
+
+/// Writes M2 of up to `simplesrp_digest_size` bytes if M1 is correct.
+SIMPLESRP_C_API int simplesrp_server_verify_session(simplesrp_server* server,
+                                                    const uint8_t* A, size_t A_size,
+                                                    const uint8_t* M1, size_t M1_size,
+                                                    uint8_t* M2, size_t* M2_size);
+
+/// Returns number of written bytes, zero if session is not established or `K_size` is too small.
+SIMPLESRP_C_API size_t simplesrp_server_session_key(const simplesrp_server* server, uint8_t* K, size_t K_size);
+
+/// Returns NULL for unknown `bits`, `digest` or `flags`.
+SIMPLESRP_C_API simplesrp_generator* simplesrp_generator_new(int bits, int digest, unsigned flags);
+SIMPLESRP_C_API void simplesrp_generator_free(simplesrp_generator* generator);
+
+/// Writes the verifier of `username`, `password` and `salt`, left-padded to `simplesrp_bignum_size`.
+SIMPLESRP_C_API int simplesrp_generator_verifier(simplesrp_generator* generator,
+                                                 const char* username, size_t username_size,
+                                                 const char* password, size_t password_size,
+                                                 const uint8_t* salt, size_t salt_size,
+                                                 uint8_t* verifier, size_t verifier_size);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,115 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#pragma once
+
+#include <simplesrp/simplesrp.h>
+
+namespace simplesrp {
+    /// Record of `SRPVerifierStore`. Points into the mapped file and is valid while the store is open.
+    struct SRPVerifierView {
+        const char* username = nullptr;
+        size_t usernameSize = 0;
+        const uint8_t* salt = nullptr;
+        size_t saltSize = 0;
+        
+        /// Left-padded to the size of N.
+        const uint8_t* verifier = nullptr;
+        size_t verifierSize = 0;
+    };
+    
+    /// Read-only file of usernames, salts and verifiers built by `SRPVerifierStoreBuilder`.
+    /// The file is memory-mapped and looked up through an open-addressing hash index on username,
+    /// so opening is cheap and only touched pages become resident. Lookups are thread-safe.
+    ///
+    /// Layout (little-endian): 64-byte header, index of `uint32` record numbers, fixed-size records
+    /// (username hash, offset and sizes of username and salt, verifier slot of N size),
+    /// then usernames and salts.
+    class SRPVerifierStore {
+    public:
+        SRPVerifierStore() = default;
+        ~SRPVerifierStore();
+        
+        SRPVerifierStore(const SRPVerifierStore&) = delete;
+        SRPVerifierStore& operator=(const SRPVerifierStore&) = delete;
+        
+        /// Returns false if the file cannot be mapped or is not a valid store.
+        bool open(const std::string& path);
+        void close();
+        bool isOpen() const;
+        
+        /// Parameters the verifiers were generated with.
+        SRPBits srpBits() const;
+        DigestType digestType() const;
+        Flags flags() const;
+        
+        /// Number of records.
+        size_t size() const;
+        
+        bool find(const char* username, size_t usernameSize, SRPVerifierView& view) const;
+        bool find(const std::string& username, SRPVerifierView& view) const;
+        
+    private:
+        const uint8_t* m_data = nullptr;
+        size_t m_size = 0;
+        Buffer m_buffer;
+        
+        SRPBits m_srpBits = SRPBits::Key1024;
+        DigestType m_digestType = DigestType::SHA1;
+        Flags m_flags = {};
+        size_t m_verifierSize = 0;
+        size_t m_recordSize = 0;
+        size_t m_recordCount = 0;
+        size_t m_bucketCount = 0;
+        const uint8_t* m_buckets = nullptr;
+        const uint8_t* m_records = nullptr;
+        const uint8_t* m_strings = nullptr;
+        size_t m_stringsSize = 0;
+    };
+    
+    /// Collects records and writes them as `SRPVerifierStore` file.
+    class SRPVerifierStoreBuilder {
+    public:
+        SRPVerifierStoreBuilder(DigestType digestType, SRPBits srpBits);
+        
+        /// Used for records added with passwords. Set `generator.params.flags` before `write`.
+        SRPVerifierGenerator generator;
+        
+        /// Adds user whose salt and verifier are generated by `write`.
+        void add(std::string username, std::string password, size_t saltSize = 16);
+        
+        /// Adds user with already generated salt and verifier.
+        void add(std::string username, Buffer salt, Buffer verifier);
+        
+        /// Generates missing verifiers using `threadCount` threads (0 means number of hardware threads)
+        /// and writes the file through a temporary one renamed over `path`, so readers never see
+        /// a partial store. Returns false on duplicate or too long usernames, empty verifiers,
+        /// failed salt generation or I/O errors; `path` is left untouched in that case.
+        bool write(const std::string& path, size_t threadCount = 0);
+        
+    private:
+        SRPBits m_srpBits;
+        std::vector<SRPVerifierGenerator::Record> m_pending;
+        std::vector<SRPVerifierGenerator::Record> m_records;
+    };
+}
@@ -0,0 +1,71 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace simplesrp::utils {
+    /// Fixed set of worker threads executing submitted tasks in FIFO order.
+    class ThreadPool {
+    public:
+        /// Zero `threadCount` means number of hardware threads.
+        /// Non-zero `queueCapacity` limits number of tasks waiting for a free thread.
+        explicit ThreadPool(size_t threadCount = 0, size_t queueCapacity = 0);
+        ~ThreadPool();
+        
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+        
+        size_t threadCount() const;
+        
+        size_t queueSize() const;
+        
+        /// Enqueues the task, waiting for free space if the queue is full.
+        void submit(std::function<void()> task);
+        
+        /// Enqueues the task only if the queue is not full.
+        bool trySubmit(std::function<void()> task);
+        
+        /// Calls `fn(i)` for each i in [0, count) on pool threads and waits until all calls finish.
+        /// Must not be called from the pool's own threads.
+        void parallelFor(size_t count, const std::function<void(size_t)>& fn);
+        
+    private:
+        void worker();
+        
+    private:
+        std::vector<std::thread> m_threads;
+        std::deque<std::function<void()>> m_tasks;
+        size_t m_capacity = 0;
+        mutable std::mutex m_lock;
+        std::condition_variable m_cv;
+        std::condition_variable m_spaceCv;
+        bool m_stop = false;
+    };
+}
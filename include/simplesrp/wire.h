@@ -0,0 +1,115 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#pragma once
+
+#include <simplesrp/details.h>
+
+namespace simplesrp {
+    /// Bytes inside a buffer owned by someone else, e.g. the receive buffer a message was decoded from.
+    struct SRPBytesView {
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+    };
+    
+    /// First message: username and A.
+    struct SRPClientHelloView {
+        const char* username = nullptr;
+        size_t usernameSize = 0;
+        
+        /// Left-padded to the size of N.
+        SRPBytesView A;
+    };
+    
+    /// Second message: salt and B.
+    struct SRPServerChallengeView {
+        SRPBytesView salt;
+        
+        /// Left-padded to the size of N.
+        SRPBytesView B;
+    };
+    
+    /// Third and fourth messages: M1 and M2, without leading zero bytes as the handshake classes produce them.
+    struct SRPProofView {
+        SRPBytesView M;
+    };
+    
+    /// Compact binary framing of the four handshake messages of one group and digest.
+    ///
+    /// Every message starts with a 4-byte header: version, message type, `SRPBits` and `DigestType`.
+    /// A and B take the size of N, M1 and M2 the digest size, both left-padded with zeroes;
+    /// lengths are big-endian:
+    ///   client hello      header | u16 username size | username | A
+    ///   server challenge  header | u8 salt size | salt | B
+    ///   client proof      header | M1
+    ///   server proof      header | M2
+    ///
+    /// `encode...` methods write into caller buffers and return the number of written bytes,
+    /// zero if a field does not fit its width or `outSize` is smaller than `...Size()`.
+    /// `decode...` methods check the header and lengths and return views pointing into `data`,
+    /// which must outlive them. Nothing is allocated.
+    class SRPWireCodec {
+    public:
+        enum MessageType : uint8_t {
+            ClientHello = 1,
+            ServerChallenge = 2,
+            ClientProof = 3,
+            ServerProof = 4,
+        };
+        
+        static constexpr uint8_t Version = 1;
+        static constexpr size_t HeaderSize = 4;
+        
+        SRPWireCodec(DigestType digestType, SRPBits srpBits);
+        
+        size_t clientHelloSize(size_t usernameSize) const;
+        size_t serverChallengeSize(size_t saltSize) const;
+        size_t proofSize() const;
+        
+        size_t encodeClientHello(const char* username, size_t usernameSize, const uint8_t* A, size_t ASize,
+                                 uint8_t* out, size_t outSize) const;
+        size_t encodeServerChallenge(const uint8_t* salt, size_t saltSize, const uint8_t* B, size_t BSize,
+                                     uint8_t* out, size_t outSize) const;
+        size_t encodeClientProof(const uint8_t* M1, size_t M1Size, uint8_t* out, size_t outSize) const;
+        size_t encodeServerProof(const uint8_t* M2, size_t M2Size, uint8_t* out, size_t outSize) const;
+        
+        bool decodeClientHello(const uint8_t* data, size_t size, SRPClientHelloView& hello) const;
+        bool decodeServerChallenge(const uint8_t* data, size_t size, SRPServerChallengeView& challenge) const;
+        bool decodeClientProof(const uint8_t* data, size_t size, SRPProofView& proof) const;
+        bool decodeServerProof(const uint8_t* data, size_t size, SRPProofView& proof) const;
+        
+        /// Type of the message in `data` if its header matches this codec, zero otherwise.
+        uint8_t messageType(const uint8_t* data, size_t size) const;
+        
+    private:
+        size_t encodeProof(MessageType type, const uint8_t* M, size_t MSize, uint8_t* out, size_t outSize) const;
+        bool decodeProof(MessageType type, const uint8_t* data, size_t size, SRPProofView& proof) const;
+        uint8_t* writeHeader(MessageType type, uint8_t* out) const;
+        
+    private:
+        DigestType m_digestType;
+        SRPBits m_srpBits;
+        size_t m_bignumSize;
+        size_t m_digestSize;
+    };
+}
@@ -0,0 +1,213 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#include <simplesrp/simplesrp.h>
+#include <simplesrp/core.h>
+#include <simplesrp/group.h>
+#include <simplesrp/multihash.h>
+
+#include <openssl/crypto.h>
+
+#include <array>
+
+using namespace simplesrp;
+
+namespace {
+    constexpr size_t DigestTypeCount = 5;
+    
+    /// Collects messages of any digest type and hashes them with one MultiDigest per type.
+    class HashJobs {
+    public:
+        void add(DigestType digestType, const Buffer& message, uint8_t* hash) {
+            Jobs& jobs = m_jobs[static_cast<size_t>(digestType)];
+            jobs.data.push_back(message.data());
+            jobs.sizes.push_back(message.size());
+            jobs.hashes.push_back(hash);
+        }
+        
+        void run() {
+            for (size_t type = 0; type < DigestTypeCount; type++) {
+                Jobs& jobs = m_jobs[type];
+                if (!jobs.data.empty()) {
+                    utils::MultiDigest(static_cast<DigestType>(type)).hash(jobs.data.size(), jobs.data.data(), jobs.sizes.data(), jobs.hashes.data());
+                }
+                jobs.data.clear();
+                jobs.sizes.clear();
+                jobs.hashes.clear();
+            }
+        }
+        
+    private:
+        struct Jobs {
+            std::vector<const uint8_t*> data;
+            std::vector<size_t> sizes;
+            std::vector<uint8_t*> hashes;
+        };
+        std::array<Jobs, DigestTypeCount> m_jobs;
+    };
+    
+    void AppendBignum(Buffer& message, const BIGNUM* bn, size_t minSize) {
+        const size_t size = std::max(minSize, static_cast<size_t>(BN_num_bytes(bn)));
+        const size_t offset = message.size();
+        message.resize(offset + size);
+        BN_bn2binpad(bn, message.data() + offset, static_cast<int>(size));
+    }
+    
+    void AppendStripped(Buffer& message, const uint8_t* data, size_t size) {
+        while (size > 0 && *data == 0) {
+            data++;
+            size--;
+        }
+        message.insert(message.end(), data, data + size);
+    }
+    
+    struct Pending {
+        SRPServer::Verification* item = nullptr;
+        const SRPGroup* group = nullptr;
+        size_t hashSize = 0;
+        bn::BignumPtr A;
+        Buffer message;
+        uint8_t hash[SHA512_DIGEST_LENGTH] = {};
+        uint8_t K[SHA512_DIGEST_LENGTH] = {};
+    };
+}
+
+void SRPServer::verifySessions(Verification* items, size_t count) {
+    BN_CTX* ctx = bn::ThreadContext();
+    
+    // Safety checks, then u = H(PAD(A) | PAD(B)) of all sessions.
+    std::vector<Pending> pending;
+    pending.reserve(count);
+    HashJobs jobs;
+    for (size_t i = 0; i < count; i++) {
+        Verification& item = items[i];
+        SRPServer* server = item.server;
+        item.verified = false;
+        item.M2.clear();
+        if (!server || !server->m_B) {
+            continue;
+        }
+        if (!core::IsBuiltInServerVerification(server->routines)) {
+            item.verified = server->verifySession(item.A, item.M1, item.M2);
+            continue;
+        }
+        server->m_verified = false;
+        
+        Pending state;
+        state.item = &item;
+        state.group = &SRPGroup::Get(server->params);
+        state.hashSize = DigestSize(server->params.digestType);
+        state.A = bn::FromBytes(item.A);
+        if (!core::ServerSafetyCheck(*state.group, state.A.get(), ctx)) {
+            if (server->metrics) {
+                server->metrics->recordFailedSafetyCheck();
+            }
+            continue;
+        }
+        
+        const size_t bnSize = core::HashedBignumSize(*state.group, SRPFlagSkipZeroes_k_U_X);
+        AppendBignum(state.message, state.A.get(), bnSize);
+        AppendBignum(state.message, server->m_B.get(), bnSize);
+        pending.push_back(std::move(state));
+    }
+    for (auto& state : pending) {
+        jobs.add(state.group->digestType, state.message, state.hash);
+    }
+    jobs.run();
+    
+    // Premaster secrets, then K = H(S). Sessions whose S cannot be computed stay unverified.
+    auto u = bn::New();
+    auto S = bn::New();
+    size_t computed = 0;
+    for (auto& state : pending) {
+        SRPServer* server = state.item->server;
+        BN_bin2bn(state.hash, static_cast<int>(state.hashSize), u.get());
+        if (!core::ServerPremaster(*state.group, u.get(), server->m_v.get(), server->m_b.get(), state.A.get(), S.get(), ctx)) {
+            continue;
+        }
+        state.message.clear();
+        AppendBignum(state.message, S.get(), 0);
+        if (&pending[computed] != &state) {
+            pending[computed] = std::move(state);
+        }
+        computed++;
+    }
+    pending.resize(computed);
+    for (auto& state : pending) {
+        jobs.add(state.group->digestType, state.message, state.K);
+    }
+    jobs.run();
+    
+    // M1 = H(H(N) xor H(g) | H(I) | s | A | B | K), starting with H(I).
+    for (auto& state : pending) {
+        const std::string& username = state.item->server->m_username;
+        state.message.assign(username.begin(), username.end());
+        jobs.add(state.group->digestType, state.message, state.hash);
+    }
+    jobs.run();
+    
+    for (auto& state : pending) {
+        SRPServer* server = state.item->server;
+        const size_t bnSize = core::HashedBignumSize(*state.group, SRPFlagSkipZeroes_M1_M2);
+        state.message.assign(state.group->hashXor.begin(), state.group->hashXor.end());
+        state.message.insert(state.message.end(), state.hash, state.hash + state.hashSize);
+        state.message.insert(state.message.end(), server->m_salt.begin(), server->m_salt.end());
+        AppendBignum(state.message, state.A.get(), bnSize);
+        AppendBignum(state.message, server->m_B.get(), bnSize);
+        AppendStripped(state.message, state.K, state.hashSize);
+        jobs.add(state.group->digestType, state.message, state.hash);
+    }
+    jobs.run();
+    
+    // Compare M1 as `verifySession` does, then M2 = H(A | M1 | K) of matching sessions.
+    for (auto& state : pending) {
+        Verification& item = *state.item;
+        item.server->m_K = bn::FromBytes(state.K, state.hashSize);
+        
+        Buffer serverM1;
+        AppendStripped(serverM1, state.hash, state.hashSize);
+        if (serverM1.size() != item.M1.size() || CRYPTO_memcmp(serverM1.data(), item.M1.data(), serverM1.size()) != 0) {
+            if (item.server->metrics) {
+                item.server->metrics->recordM1Mismatch();
+            }
+            continue;
+        }
+        item.verified = true;
+        item.server->m_verified = true;
+        
+        state.message.clear();
+        AppendBignum(state.message, state.A.get(), core::HashedBignumSize(*state.group, SRPFlagSkipZeroes_M1_M2));
+        AppendStripped(state.message, serverM1.data(), serverM1.size());
+        AppendStripped(state.message, state.K, state.hashSize);
+        jobs.add(state.group->digestType, state.message, state.hash);
+    }
+    jobs.run();
+    
+    for (auto& state : pending) {
+        if (state.item->verified) {
+            AppendStripped(state.item->M2, state.hash, state.hashSize);
+        }
+        OPENSSL_cleanse(state.K, sizeof(state.K));
+        OPENSSL_cleanse(state.message.data(), state.message.size());
+    }
+}
@@ -21,6 +21,11 @@
 //  SOFTWARE.
 
 #include <simplesrp/bn.h>
+#include <simplesrp/random.h>
+
+#include <openssl/crypto.h>
+
+#include <algorithm>
 
 namespace simplesrp::bn {
     BignumPtr Own(BIGNUM* bn) {
@@ -28,11 +33,41 @@ namespace simplesrp::bn {
     }
     
     BignumPtr Random(size_t size) {
+        return RandomBits(size * 8);
+    }
+    
+    BignumPtr RandomBits(size_t bits) {
         BignumPtr ptr = Own(BN_new());
-        BN_rand(ptr.get(), static_cast<int>(size * 8), 0, 0);
+        RandomBits(ptr.get(), bits);
         return ptr;
     }
     
+    bool RandomBits(BIGNUM* r, size_t bits) {
+        uint8_t stackBuffer[1024];
+        Buffer heapBuffer;
+        uint8_t* buffer = stackBuffer;
+        const size_t size = (bits + 7) / 8;
+        if (size > sizeof(stackBuffer)) {
+            heapBuffer.resize(size);
+            buffer = heapBuffer.data();
+        }
+        if (!size) {
+            BN_zero(r);
+            return true;
+        }
+        if (!utils::RandomBytes(buffer, size)) {
+            return false;
+        }
+        
+        const int bit = static_cast<int>((bits - 1) % 8);
+        buffer[0] |= static_cast<uint8_t>(1 << bit);
+        buffer[0] &= static_cast<uint8_t>(~(0xff << (bit + 1)));
+        
+        const bool ok = BN_bin2bn(buffer, static_cast<int>(size), r) != nullptr;
+        OPENSSL_cleanse(buffer, size);
+        return ok;
+    }
+    
     BignumPtr New() {
         return Own(BN_new());
     }
@@ -46,15 +81,8 @@ namespace simplesrp::bn {
     }
     
     Buffer ToBytes(const BIGNUM* bn, size_t minSize) {
-        Buffer bin(BN_num_bytes(bn));
-        BN_bn2bin(bn, bin.data());
-        
-        const size_t binSize = bin.size();
-        if (binSize < minSize)
-        {
-            bin.insert(bin.begin(), minSize - binSize, 0x00);
-        }
-        
+        Buffer bin(std::max(minSize, static_cast<size_t>(BN_num_bytes(bn))));
+        BN_bn2binpad(bn, bin.data(), static_cast<int>(bin.size()));
         return bin;
     }
     
@@ -62,7 +90,161 @@ namespace simplesrp::bn {
         return ToBytes(bn.get(), minSize);
     }
     
-    std::unique_ptr<BN_CTX, decltype(&BN_CTX_free)> MakeContext() {
-        return std::unique_ptr<BN_CTX, decltype(&BN_CTX_free)>(BN_CTX_new(), BN_CTX_free);
-    };
+    int Compare(const BIGNUM* a, const BIGNUM* b) {
+        return BN_cmp(a, b);
+    }
+    
+    ContextPtr MakeContext() {
+        return ContextPtr(BN_CTX_new(), BN_CTX_free);
+    }
+    
+    BN_CTX* ThreadContext() {
+        thread_local ContextPtr s_ctx = MakeContext();
+        return s_ctx.get();
+    }
+    
+    MontContextPtr MakeMontContext(const BIGNUM* m) {
+        std::shared_ptr<BN_MONT_CTX> mont(BN_MONT_CTX_new(), BN_MONT_CTX_free);
+        if (!mont || !BN_MONT_CTX_set(mont.get(), m, ThreadContext())) {
+            return nullptr;
+        }
+        return mont;
+    }
+    
+    FixedBaseTable::FixedBaseTable(const BIGNUM* g, const BIGNUM* m, MontContextPtr mont, size_t maxBits, size_t teeth)
+    : m_g(g)
+    , m_m(m)
+    , m_mont(std::move(mont))
+    , m_maxBits(maxBits)
+    , m_teeth(teeth)
+    , m_spacing(teeth ? (maxBits + teeth - 1) / teeth : 0)
+    , m_entryWords((BN_num_bytes(m) + 7) / 8)
+    {
+        if (!m_teeth || !m_spacing || m_teeth > MaxTeeth) {
+            return;
+        }
+        
+        BN_MONT_CTX* montCtx = const_cast<BN_MONT_CTX*>(m_mont.get());
+        BN_CTX* ctx = ThreadContext();
+        
+        // table[0] = 1, table[1 << j] = g^(2^(j * spacing)), kept in Montgomery form.
+        std::vector<BignumPtr> table(size_t(1) << m_teeth);
+        table[0] = New();
+        BN_to_montgomery(table[0].get(), BN_value_one(), montCtx, ctx);
+        for (size_t j = 0; j < m_teeth; j++) {
+            auto base = New();
+            if (j == 0) {
+                BN_to_montgomery(base.get(), g, montCtx, ctx);
+            } else {
+                BN_copy(base.get(), table[size_t(1) << (j - 1)].get());
+                for (size_t i = 0; i < m_spacing; i++) {
+                    BN_mod_mul_montgomery(base.get(), base.get(), base.get(), montCtx, ctx);
+                }
+            }
+            table[size_t(1) << j] = base;
+        }
+        
+        // table[idx] = product of bases selected by bits of idx.
+        for (size_t idx = 3; idx < table.size(); idx++) {
+            if (table[idx]) {
+                continue;
+            }
+            size_t high = 1;
+            while ((high << 1) <= idx) {
+                high <<= 1;
+            }
+            auto value = New();
+            BN_mod_mul_montgomery(value.get(), table[idx ^ high].get(), table[high].get(), montCtx, ctx);
+            table[idx] = value;
+        }
+        
+        // Flat little-endian words, so that `exp` can read every entry for every column.
+        m_table.resize(table.size() * m_entryWords);
+        for (size_t idx = 0; idx < table.size(); idx++) {
+            BN_bn2lebinpad(table[idx].get(), reinterpret_cast<uint8_t*>(m_table.data() + idx * m_entryWords),
+                           static_cast<int>(m_entryWords * 8));
+        }
+    }
+    
+    bool FixedBaseTable::exp(BIGNUM* r, const BIGNUM* e, BN_CTX* ctx) const {
+        // Exponents fitting single comb row gain nothing compared to sliding window.
+        const size_t bits = BN_num_bits(e);
+        if (m_table.empty() || bits > m_maxBits || bits <= m_spacing || BN_is_negative(e)) {
+            return ModExp(r, m_g, e, m_m, m_mont.get(), ctx);
+        }
+        
+        BN_MONT_CTX* montCtx = const_cast<BN_MONT_CTX*>(m_mont.get());
+        thread_local std::vector<uint64_t> s_words;
+        s_words.resize(m_entryWords);
+        
+        BN_CTX_start(ctx);
+        BIGNUM* entry = BN_CTX_get(ctx);
+        bool ok = entry && select(0, s_words.data(), entry) && BN_copy(r, entry);
+        
+        // idx is made of secret bits: every column costs one squaring, a scan of the whole table
+        // and one multiplication, by one for zero columns.
+        for (size_t i = m_spacing; ok && i-- > 0;) {
+            size_t idx = 0;
+            for (size_t j = 0; j < m_teeth; j++) {
+                idx |= size_t(BN_is_bit_set(e, static_cast<int>(j * m_spacing + i))) << j;
+            }
+            ok = BN_mod_mul_montgomery(r, r, r, montCtx, ctx)
+                && select(idx, s_words.data(), entry)
+                && BN_mod_mul_montgomery(r, r, entry, montCtx, ctx);
+        }
+        
+        OPENSSL_cleanse(s_words.data(), s_words.size() * sizeof(uint64_t));
+        BN_clear(entry);
+        BN_CTX_end(ctx);
+        return ok && BN_from_montgomery(r, r, montCtx, ctx);
+    }
+    
+    bool FixedBaseTable::select(size_t idx, uint64_t* words, BIGNUM* entry) const {
+        std::fill(words, words + m_entryWords, 0);
+        const uint64_t* row = m_table.data();
+        for (size_t i = 0; i < (size_t(1) << m_teeth); i++, row += m_entryWords) {
+            const uint64_t diff = i ^ idx;
+            const uint64_t mask = ((diff | (0 - diff)) >> 63) - 1;   // all ones iff i == idx
+            for (size_t w = 0; w < m_entryWords; w++) {
+                words[w] |= row[w] & mask;
+            }
+        }
+        return BN_lebin2bn(reinterpret_cast<const uint8_t*>(words), static_cast<int>(m_entryWords * 8), entry) != nullptr;
+    }
+    
+    ChunkedBaseTable::ChunkedBaseTable(const BIGNUM* g, const BIGNUM* m, MontContextPtr mont, size_t maxBits, size_t chunks)
+    : m_m(m)
+    , m_mont(std::move(mont))
+    , m_chunkBits(chunks ? (maxBits + chunks - 1) / chunks : 0)
+    {
+        if (!m_chunkBits) {
+            return;
+        }
+        
+        BN_CTX* ctx = ThreadContext();
+        auto shift = New();
+        BN_set_bit(shift.get(), static_cast<int>(m_chunkBits));
+        
+        m_bases.resize(chunks);
+        m_bases[0] = Own(BN_dup(g));
+        for (size_t i = 1; i < chunks; i++) {
+            m_bases[i] = New();
+            ModExp(m_bases[i].get(), m_bases[i - 1].get(), shift.get(), m_m, m_mont.get(), ctx);
+        }
+    }
+    
+    bool ChunkedBaseTable::exp(BIGNUM* r, size_t i, const BIGNUM* e, BN_CTX* ctx) const {
+        if (i >= m_bases.size() || BN_is_negative(e)) {
+            return false;
+        }
+        
+        BN_CTX_start(ctx);
+        BIGNUM* piece = BN_CTX_get(ctx);
+        const bool ok = piece
+            && BN_rshift(piece, e, static_cast<int>(i * m_chunkBits))
+            && (BN_num_bits(piece) <= static_cast<int>(m_chunkBits) || BN_mask_bits(piece, static_cast<int>(m_chunkBits)))
+            && ModExp(r, m_bases[i].get(), piece, m_m, m_mont.get(), ctx);
+        BN_CTX_end(ctx);
+        return ok;
+    }
 }
@@ -0,0 +1,119 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#include <simplesrp/bn.h>
+
+#include <openssl/crypto.h>
+
+#include <gmp.h>
+
+/// GMP backend of the modular arithmetic in `bn.h`. Operands are converted through big-endian
+/// bytes into per-thread mpz_t temporaries; exponentiation uses side-channel silent mpz_powm_sec.
+namespace simplesrp::bn {
+    namespace {
+        struct Temporaries {
+            Temporaries() { mpz_inits(a, b, m, r, nullptr); }
+            ~Temporaries() { mpz_clears(a, b, m, r, nullptr); }
+            
+            mpz_t a, b, m, r;
+            Buffer bytes;
+        };
+        
+        Temporaries& ThreadTemporaries() {
+            thread_local Temporaries s_temporaries;
+            return s_temporaries;
+        }
+        
+        void Import(mpz_t z, const BIGNUM* x, Buffer& bytes) {
+            bytes.resize(BN_num_bytes(x));
+            BN_bn2bin(x, bytes.data());
+            mpz_import(z, bytes.size(), 1, 1, 1, 0, bytes.data());
+            if (BN_is_negative(x)) {
+                mpz_neg(z, z);
+            }
+            OPENSSL_cleanse(bytes.data(), bytes.size());
+        }
+        
+        /// Writes non-negative `z` into `x`.
+        bool Export(BIGNUM* x, const mpz_t z, Buffer& bytes) {
+            bytes.resize((mpz_sizeinbase(z, 2) + 7) / 8);
+            size_t size = 0;
+            mpz_export(bytes.data(), &size, 1, 1, 1, 0, z);
+            const bool ok = BN_bin2bn(bytes.data(), static_cast<int>(size), x) != nullptr;
+            OPENSSL_cleanse(bytes.data(), bytes.size());
+            return ok;
+        }
+        
+        template <class Operation>
+        bool Binary(BIGNUM* r, const BIGNUM* a, const BIGNUM* b, const BIGNUM* m, Operation operation) {
+            Temporaries& t = ThreadTemporaries();
+            Import(t.a, a, t.bytes);
+            Import(t.b, b, t.bytes);
+            Import(t.m, m, t.bytes);
+            operation(t.r, t.a, t.b);
+            mpz_mod(t.r, t.r, t.m);
+            return Export(r, t.r, t.bytes);
+        }
+    }
+    
+    const char* BackendName() {
+        return "GMP";
+    }
+    
+    bool ModExp(BIGNUM* r, const BIGNUM* a, const BIGNUM* p, const BIGNUM* m, const BN_MONT_CTX*, BN_CTX*) {
+        if (BN_is_negative(p) || !BN_is_odd(m)) {
+            return false;
+        }
+        if (BN_is_zero(p)) {
+            return BN_one(r);
+        }
+        
+        Temporaries& t = ThreadTemporaries();
+        Import(t.a, a, t.bytes);
+        Import(t.b, p, t.bytes);
+        Import(t.m, m, t.bytes);
+        mpz_mod(t.a, t.a, t.m);
+        mpz_powm_sec(t.r, t.a, t.b, t.m);
+        return Export(r, t.r, t.bytes);
+    }
+    
+    bool ModMul(BIGNUM* r, const BIGNUM* a, const BIGNUM* b, const BIGNUM* m, BN_CTX*) {
+        return Binary(r, a, b, m, mpz_mul);
+    }
+    
+    bool ModAdd(BIGNUM* r, const BIGNUM* a, const BIGNUM* b, const BIGNUM* m, BN_CTX*) {
+        return Binary(r, a, b, m, mpz_add);
+    }
+    
+    bool ModSub(BIGNUM* r, const BIGNUM* a, const BIGNUM* b, const BIGNUM* m, BN_CTX*) {
+        return Binary(r, a, b, m, mpz_sub);
+    }
+    
+    bool Mod(BIGNUM* r, const BIGNUM* a, const BIGNUM* m, BN_CTX*) {
+        Temporaries& t = ThreadTemporaries();
+        Import(t.a, a, t.bytes);
+        Import(t.m, m, t.bytes);
+        mpz_mod(t.r, t.a, t.m);
+        return Export(r, t.r, t.bytes);
+    }
+}
@@ -0,0 +1,58 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#include <simplesrp/bn.h>
+
+/// OpenSSL backend of the modular arithmetic in `bn.h`.
+namespace simplesrp::bn {
+    const char* BackendName() {
+        return "OpenSSL";
+    }
+    
+    bool ModExp(BIGNUM* r, const BIGNUM* a, const BIGNUM* p, const BIGNUM* m, const BN_MONT_CTX* mont, BN_CTX* ctx) {
+        // OpenSSL never modifies Montgomery context passed to exponentiation routines.
+        BN_MONT_CTX* montCtx = const_cast<BN_MONT_CTX*>(mont);
+        
+        // Small bases (usually generator g) have dedicated faster path.
+        if (!BN_is_negative(a) && BN_num_bits(a) <= BN_BITS2 && BN_num_bits(a) < BN_num_bits(m)) {
+            return BN_mod_exp_mont_word(r, BN_get_word(a), p, m, ctx, montCtx);
+        }
+        return BN_mod_exp_mont(r, a, p, m, ctx, montCtx);
+    }
+    
+    bool ModMul(BIGNUM* r, const BIGNUM* a, const BIGNUM* b, const BIGNUM* m, BN_CTX* ctx) {
+        return BN_mod_mul(r, a, b, m, ctx);
+    }
+    
+    bool ModAdd(BIGNUM* r, const BIGNUM* a, const BIGNUM* b, const BIGNUM* m, BN_CTX* ctx) {
+        return BN_mod_add(r, a, b, m, ctx);
+    }
+    
+    bool ModSub(BIGNUM* r, const BIGNUM* a, const BIGNUM* b, const BIGNUM* m, BN_CTX* ctx) {
+        return BN_mod_sub(r, a, b, m, ctx);
+    }
+    
+    bool Mod(BIGNUM* r, const BIGNUM* a, const BIGNUM* m, BN_CTX* ctx) {
+        return BN_nnmod(r, a, m, ctx);
+    }
+}
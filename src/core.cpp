@@ -0,0 +1,146 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#include <simplesrp/core.h>
+
+#include <openssl/crypto.h>
+
+#include <cstring>
+
+using namespace simplesrp;
+
+namespace {
+    /// Temporary BIGNUMs taken from BN_CTX for the lifetime of the scope.
+    class ContextFrame {
+    public:
+        explicit ContextFrame(BN_CTX* ctx) : m_ctx(ctx) { BN_CTX_start(m_ctx); }
+        ~ContextFrame() { BN_CTX_end(m_ctx); }
+        BIGNUM* get() { return BN_CTX_get(m_ctx); }
+        
+    private:
+        BN_CTX* m_ctx;
+    };
+    
+    bool ModExp(const SRPGroup& group, const bn::MontKernel* kernel, BIGNUM* r, const BIGNUM* a, const BIGNUM* p, BN_CTX* ctx) {
+        return kernel
+            ? kernel->exp(r, a, p, ctx)
+            : bn::ModExp(r, a, p, group.gn->N, group.mont.get(), ctx);
+    }
+}
+
+size_t core::EphemeralBits(const SRPParams& params) {
+    const size_t maxBits = BN_num_bytes(params.gn->N) * 8;
+    return params.ephemeralBits ? std::min(std::max(params.ephemeralBits, MinEphemeralBits), maxBits) : maxBits;
+}
+
+size_t core::CopyStripped(const uint8_t* data, size_t size, uint8_t* out, size_t outSize) {
+    while (size > 0 && *data == 0) {
+        data++;
+        size--;
+    }
+    if (size > outSize) {
+        return 0;
+    }
+    memcpy(out, data, size);
+    return size;
+}
+
+bool core::EqualStripped(const uint8_t* lhs, size_t lhsSize, const uint8_t* rhs, size_t rhsSize) {
+    while (lhsSize > 0 && *lhs == 0) {
+        lhs++;
+        lhsSize--;
+    }
+    while (rhsSize > 0 && *rhs == 0) {
+        rhs++;
+        rhsSize--;
+    }
+    return lhsSize == rhsSize && CRYPTO_memcmp(lhs, rhs, lhsSize) == 0;
+}
+
+bool core::Calculate_A(const SRPGroup& group, const BIGNUM* a, BIGNUM* A, BN_CTX* ctx, const bn::MontKernel* kernel) {
+    return ModExp(group, kernel, A, group.gn->g, a, ctx);
+}
+
+bool core::Combine_B(const SRPGroup& group, const BIGNUM* gb, const BIGNUM* v, const BIGNUM* k, BIGNUM* B, BN_CTX* ctx) {
+    ContextFrame frame(ctx);
+    BIGNUM* kv = frame.get();
+    
+    /* B = kv + g^b */
+    return kv
+        && bn::ModMul(kv, k, v, group.gn->N, ctx)
+        && bn::ModAdd(B, kv, gb, group.gn->N, ctx);
+}
+
+bool core::Calculate_kv(const SRPGroup& group, const BIGNUM* k, const BIGNUM* v, BIGNUM* kv, BN_CTX* ctx) {
+    return bn::ModMul(kv, k, v, group.gn->N, ctx);
+}
+
+bool core::CombineKV_B(const SRPGroup& group, const BIGNUM* gb, const BIGNUM* kv, BIGNUM* B, BN_CTX* ctx) {
+    return bn::ModAdd(B, kv, gb, group.gn->N, ctx);
+}
+
+bool core::ClientPremaster(const SRPGroup& group, const BIGNUM* u, const BIGNUM* x, const BIGNUM* k,
+                           const BIGNUM* a, const BIGNUM* B, BIGNUM* S, BN_CTX* ctx,
+                           const bn::MontKernel* kernel) {
+    ContextFrame frame(ctx);
+    BIGNUM* tmp1 = frame.get();
+    BIGNUM* tmp2 = frame.get();
+    BIGNUM* tmp3 = frame.get();
+    if (!tmp3) {
+        return false;
+    }
+    
+    const BIGNUM* N = group.gn->N;
+    return BN_mul(tmp1, u, x, ctx)
+        && BN_add(tmp2, a, tmp1)                                    // tmp2 = (a + ux)
+        && ModExp(group, kernel, tmp1, group.gn->g, x, ctx)
+        && bn::ModMul(tmp3, k, tmp1, N, ctx)                        // tmp3 = k*(g^x)
+        && bn::ModSub(tmp1, B, tmp3, N, ctx)                        // tmp1 = (B - K*(g^x))
+        && ModExp(group, kernel, S, tmp1, tmp2, ctx);
+}
+
+bool core::ServerPremaster(const SRPGroup& group, const BIGNUM* u, const BIGNUM* v,
+                           const BIGNUM* b, const BIGNUM* A, BIGNUM* S, BN_CTX* ctx,
+                           const bn::MontKernel* kernel) {
+    ContextFrame frame(ctx);
+    BIGNUM* tmp1 = frame.get();
+    BIGNUM* tmp2 = frame.get();
+    if (!tmp2) {
+        return false;
+    }
+    
+    const BIGNUM* N = group.gn->N;
+    return ModExp(group, kernel, tmp1, v, u, ctx)
+        && bn::ModMul(tmp2, A, tmp1, N, ctx)
+        && ModExp(group, kernel, S, tmp2, b, ctx);
+}
+
+bool core::ClientSafetyCheck(const BIGNUM* B, const BIGNUM* u) {
+    return !BN_is_zero(B) && !BN_is_zero(u);
+}
+
+bool core::ServerSafetyCheck(const SRPGroup& group, const BIGNUM* A, BN_CTX* ctx) {
+    ContextFrame frame(ctx);
+    BIGNUM* tmp = frame.get();
+    return tmp && bn::Mod(tmp, A, group.gn->N, ctx) && !BN_is_zero(tmp);
+}
@@ -0,0 +1,76 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#include <simplesrp/engine.h>
+
+#include <algorithm>
+
+using namespace simplesrp;
+
+SRPServerEngine::SRPServerEngine(size_t threadCount, size_t queueCapacity)
+: m_pool(threadCount, std::max<size_t>(queueCapacity, 1))
+{}
+
+SRPServerEngine::~SRPServerEngine() = default;
+
+bool SRPServerEngine::startAuthentication(std::shared_ptr<SRPServer> server,
+                                          std::string username, Buffer salt, Buffer verifier,
+                                          StartCompletion completion) {
+    if (!server) {
+        return false;
+    }
+    
+    return m_pool.trySubmit([server = std::move(server), username = std::move(username),
+                             salt = std::move(salt), verifier = std::move(verifier),
+                             completion = std::move(completion)] {
+        Buffer B;
+        server->startAuthentication(username, salt, verifier, B);
+        if (completion) {
+            completion(B);
+        }
+    });
+}
+
+bool SRPServerEngine::verifySession(std::shared_ptr<SRPServer> server, Buffer A, Buffer M1,
+                                    VerifyCompletion completion) {
+    if (!server) {
+        return false;
+    }
+    
+    return m_pool.trySubmit([server = std::move(server), A = std::move(A), M1 = std::move(M1),
+                             completion = std::move(completion)] {
+        Buffer M2;
+        const bool verified = server->verifySession(A, M1, M2);
+        if (completion) {
+            completion(verified, M2);
+        }
+    });
+}
+
+size_t SRPServerEngine::threadCount() const {
+    return m_pool.threadCount();
+}
+
+size_t SRPServerEngine::pendingCount() const {
+    return m_pool.queueSize();
+}
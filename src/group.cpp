@@ -0,0 +1,165 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#include <simplesrp/group.h>
+#include <simplesrp/routines.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+using namespace simplesrp;
+
+namespace {
+    std::unique_ptr<SRPGroup> MakeGroup(const SRP_gN* gn, DigestType digestType, Flags flags, bn::MontContextPtr mont) {
+        auto group = std::make_unique<SRPGroup>();
+        group->mont = mont ? mont : bn::MakeMontContext(gn->N);
+        group->gn = gn;
+        group->digestType = digestType;
+        group->flags = flags;
+        group->bignumSize = BN_num_bytes(gn->N);
+        group->paddedN = bn::ToBytes(gn->N, group->bignumSize);
+        group->paddedG = bn::ToBytes(gn->g, group->bignumSize);
+        
+        const utils::Digest di(digestType);
+        
+        const bool padKUX = !(flags & SRPFlagSkipZeroes_k_U_X);
+        group->k = bn::FromBytes(di.hash({
+            padKUX ? group->paddedN : bn::ToBytes(gn->N),
+            padKUX ? group->paddedG : bn::ToBytes(gn->g),
+        }));
+        
+        const bool padM = !(flags & SRPFlagSkipZeroes_M1_M2);
+        const auto hashN = di.hash({ padM ? group->paddedN : bn::ToBytes(gn->N) });
+        const auto hashG = di.hash({ padM ? group->paddedG : bn::ToBytes(gn->g) });
+        group->hashXor.resize(di.hashSize());
+        for (size_t i = 0; i < group->hashXor.size(); i++) {
+            group->hashXor[i] = hashN[i] ^ hashG[i];
+        }
+        
+        return group;
+    }
+    
+    /// Whether `group` was built from the current values of `gn`. The group keeps its own padded
+    /// copies of N and g, so this holds even if the `SRP_gN` it was built from is gone.
+    bool BuiltFrom(const SRPGroup& group, const SRP_gN* gn) {
+        return static_cast<size_t>(BN_num_bytes(gn->N)) == group.bignumSize
+            && bn::ToBytes(gn->N, group.bignumSize) == group.paddedN
+            && bn::ToBytes(gn->g, group.bignumSize) == group.paddedG;
+    }
+}
+
+bool SRPGroup::matches(const SRP_gN* gn, DigestType digestType, Flags flags) const {
+    return this->gn == gn && this->digestType == digestType && this->flags == flags;
+}
+
+const SRPGroup* SRPGroup::Get(const SRP_gN* gn, DigestType digestType, Flags flags) {
+    if (!gn) {
+        return nullptr;
+    }
+    
+    using Key = std::tuple<const SRP_gN*, DigestType, Flags>;
+    static std::mutex s_lock;
+    static std::map<Key, std::unique_ptr<SRPGroup>> s_groups;
+    static std::vector<std::unique_ptr<SRPGroup>> s_retired;
+    
+    std::lock_guard<std::mutex> lock(s_lock);
+    auto& group = s_groups[Key(gn, digestType, flags)];
+    if (group && !BuiltFrom(*group, gn)) {
+        // Another gn at a reused address: groups are never freed, as `SRPParams::group` may still point to it.
+        s_retired.push_back(std::move(group));
+    }
+    if (!group) {
+        bn::MontContextPtr mont;
+        for (const auto& it : s_groups) {
+            if (it.second && it.second->gn == gn && BuiltFrom(*it.second, gn)) {
+                mont = it.second->mont;
+                break;
+            }
+        }
+        group = MakeGroup(gn, digestType, flags, mont);
+    }
+    return group.get();
+}
+
+std::shared_ptr<const bn::FixedBaseTable> SRPGroup::fixedBaseTable(size_t maxBits, size_t teeth) const {
+    using Key = std::tuple<const BN_MONT_CTX*, size_t, size_t>;
+    static std::mutex s_lock;
+    static std::map<Key, std::shared_ptr<const bn::FixedBaseTable>> s_tables;
+    
+    std::lock_guard<std::mutex> lock(s_lock);
+    auto& table = s_tables[Key(mont.get(), maxBits, teeth)];
+    if (!table) {
+        table = std::make_shared<bn::FixedBaseTable>(gn->g, gn->N, mont, maxBits, teeth);
+    }
+    return table;
+}
+
+std::shared_ptr<const bn::ChunkedBaseTable> SRPGroup::chunkedBaseTable(size_t maxBits, size_t chunks) const {
+    using Key = std::tuple<const BN_MONT_CTX*, size_t, size_t>;
+    static std::mutex s_lock;
+    static std::map<Key, std::shared_ptr<const bn::ChunkedBaseTable>> s_tables;
+    
+    std::lock_guard<std::mutex> lock(s_lock);
+    auto& table = s_tables[Key(mont.get(), maxBits, chunks)];
+    if (!table) {
+        table = std::make_shared<bn::ChunkedBaseTable>(gn->g, gn->N, mont, maxBits, chunks);
+    }
+    return table;
+}
+
+std::shared_ptr<const bn::MontKernel> SRPGroup::montKernel(bn::MontKernelPath path) const {
+    using Key = std::pair<const BN_MONT_CTX*, bn::MontKernelPath>;
+    static std::mutex s_lock;
+    static std::map<Key, std::shared_ptr<const bn::MontKernel>> s_kernels;
+    
+    std::lock_guard<std::mutex> lock(s_lock);
+    auto& kernel = s_kernels[Key(mont.get(), path)];
+    if (!kernel) {
+        kernel = std::make_shared<bn::MontKernel>(gn->N, mont, path);
+    }
+    return kernel;
+}
+
+const SRPGroup& SRPGroup::Get(const SRPParams& params) {
+    if (params.group && params.group->matches(params.gn, params.digestType, params.flags)) {
+        return *params.group;
+    }
+    
+    const SRPGroup* group = Get(params.gn, params.digestType, params.flags);
+    if (!group) {
+        fputs("simplesrp: SRPParams::gn is not set\n", stderr);
+        abort();
+    }
+    return *group;
+}
+
+SRPParams simplesrp::CreateParams(DigestType digestType, SRPBits srpBits) {
+    SRPParams params;
+    params.digestType = digestType;
+    params.gn = SRPRoutines::gN(srpBits);
+    params.group = SRPGroup::Get(params.gn, params.digestType, params.flags);
+    return params;
+}
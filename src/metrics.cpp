@@ -0,0 +1,82 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#include <simplesrp/metrics.h>
+
+using namespace simplesrp;
+
+namespace {
+    using Field = SRPMetricsSnapshot::Routine SRPMetricsSnapshot::*;
+    
+    constexpr Field Fields[SRPMetrics::RoutineCount] = {
+        &SRPMetricsSnapshot::randomBN,
+        &SRPMetricsSnapshot::calculate_A,
+        &SRPMetricsSnapshot::calculate_B,
+        &SRPMetricsSnapshot::combine_B,
+        &SRPMetricsSnapshot::combineKV_B,
+        &SRPMetricsSnapshot::calculate_k,
+        &SRPMetricsSnapshot::calculate_x,
+        &SRPMetricsSnapshot::calculate_u,
+        &SRPMetricsSnapshot::calculateClient_K,
+        &SRPMetricsSnapshot::calculateServer_K,
+        &SRPMetricsSnapshot::calculate_M1,
+        &SRPMetricsSnapshot::calculate_M2,
+        &SRPMetricsSnapshot::clientSafetyCheck,
+        &SRPMetricsSnapshot::serverSafetyCheck,
+    };
+}
+
+void SRPMetrics::record(Routine routine, std::chrono::nanoseconds duration) {
+    Counter& counter = m_routines[routine];
+    counter.calls.fetch_add(1, std::memory_order_relaxed);
+    counter.nanoseconds.fetch_add(static_cast<uint64_t>(duration.count()), std::memory_order_relaxed);
+}
+
+void SRPMetrics::recordFailedSafetyCheck() {
+    m_failedSafetyChecks.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SRPMetrics::recordM1Mismatch() {
+    m_M1Mismatches.fetch_add(1, std::memory_order_relaxed);
+}
+
+SRPMetricsSnapshot SRPMetrics::snapshot() const {
+    SRPMetricsSnapshot result;
+    for (size_t i = 0; i < RoutineCount; i++) {
+        SRPMetricsSnapshot::Routine& routine = result.*Fields[i];
+        routine.calls = m_routines[i].calls.load(std::memory_order_relaxed);
+        routine.nanoseconds = m_routines[i].nanoseconds.load(std::memory_order_relaxed);
+    }
+    result.failedSafetyChecks = m_failedSafetyChecks.load(std::memory_order_relaxed);
+    result.M1Mismatches = m_M1Mismatches.load(std::memory_order_relaxed);
+    return result;
+}
+
+void SRPMetrics::reset() {
+    for (Counter& counter : m_routines) {
+        counter.calls.store(0, std::memory_order_relaxed);
+        counter.nanoseconds.store(0, std::memory_order_relaxed);
+    }
+    m_failedSafetyChecks.store(0, std::memory_order_relaxed);
+    m_M1Mismatches.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,196 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#include <simplesrp/bn.h>
+
+#include "montkernel_kernels.h"
+
+#include <openssl/crypto.h>
+
+#include <algorithm>
+
+namespace simplesrp::bn {
+    namespace {
+        constexpr size_t LimbBits = 52;
+        constexpr uint64_t LimbMask = (uint64_t(1) << LimbBits) - 1;
+        
+        /// Number of 8-limb vectors for moduli of the SRP group sizes, zero for others.
+        size_t VectorsFor(int bits) {
+            switch (bits) {
+            case 1024: return 3;
+            case 1536: return 4;
+            case 2048: return 5;
+            case 3072: return 8;
+            case 4096: return 10;
+            case 6144: return 15;
+            case 8192: return 20;
+            default: return 0;
+            }
+        }
+        
+        bool CpuSupports(MontKernelPath path) {
+#if defined(SIMPLESRP_SIMD_X86)
+            switch (path) {
+            case MontKernelPath::AVX512IFMA:
+                return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512ifma");
+            default:
+                return true;
+            }
+#else
+            return path == MontKernelPath::OpenSSL;
+#endif
+        }
+        
+        void ToLimbs(const BIGNUM* x, uint64_t* limbs, size_t count, uint8_t* bytes) {
+            const size_t size = count * 8;
+            BN_bn2lebinpad(x, bytes, static_cast<int>(size));
+            for (size_t i = 0; i < count; i++) {
+                const size_t bit = i * LimbBits;
+                uint64_t word = 0;
+                for (size_t j = 0; j < 8 && bit / 8 + j < size; j++) {
+                    word |= uint64_t(bytes[bit / 8 + j]) << (8 * j);
+                }
+                limbs[i] = (word >> (bit % 8)) & LimbMask;
+            }
+        }
+        
+#if defined(SIMPLESRP_SIMD_X86)
+        /// Per-thread buffers of the SIMD path, grown to the largest modulus used on the thread.
+        struct Scratch {
+            std::vector<uint8_t> bytes;
+            std::vector<uint64_t> limbs;
+        };
+        
+        Scratch& ThreadScratch() {
+            thread_local Scratch s_scratch;
+            return s_scratch;
+        }
+        
+        bool FromLimbs(const uint64_t* limbs, size_t count, BIGNUM* x, uint8_t* bytes) {
+            const size_t size = count * 8;
+            std::fill(bytes, bytes + size, 0);
+            for (size_t i = 0; i < count; i++) {
+                // Limbs start at bit 0 or 4 of a byte, so a shifted limb fits in 7 bytes.
+                const size_t bit = i * LimbBits;
+                const uint64_t word = limbs[i] << (bit % 8);
+                for (size_t j = 0; j < 7 && bit / 8 + j < size; j++) {
+                    bytes[bit / 8 + j] |= static_cast<uint8_t>(word >> (8 * j));
+                }
+            }
+            return BN_lebin2bn(bytes, static_cast<int>(size), x) != nullptr;
+        }
+#endif
+    }
+    
+    MontKernel::MontKernel(const BIGNUM* m, MontContextPtr mont, MontKernelPath path)
+    : m_m(m)
+    , m_mont(std::move(mont))
+    , m_path(path)
+    {
+        m_vectors = VectorsFor(BN_num_bits(m));
+        if (!m_vectors || !BN_is_odd(m) || !CpuSupports(m_path)) {
+            m_path = MontKernelPath::OpenSSL;
+        }
+        if (m_path == MontKernelPath::OpenSSL) {
+            return;
+        }
+        
+        // R = 2^(52 * limbs) with 4m < R, so results of almost Montgomery multiplication stay below 2m.
+        const size_t count = m_vectors * 8;
+        m_limbs = (BN_num_bits(m) + 2 + LimbBits - 1) / LimbBits;
+        Buffer bytes(count * 8);
+        m_m52.resize(count);
+        ToLimbs(m, m_m52.data(), count, bytes.data());
+        
+        // Newton iteration doubles the number of correct low bits of m^-1 mod 2^64.
+        uint64_t inverse = m_m52[0];
+        for (int i = 0; i < 6; i++) {
+            inverse *= 2 - m_m52[0] * inverse;
+        }
+        m_k0 = (0 - inverse) & LimbMask;
+        
+        BN_CTX* ctx = ThreadContext();
+        BN_CTX_start(ctx);
+        BIGNUM* rr = BN_CTX_get(ctx);
+        m_rr52.resize(count);
+        const bool ok = rr
+            && BN_set_bit(rr, static_cast<int>(2 * LimbBits * m_limbs))
+            && BN_mod(rr, rr, m, ctx);
+        if (ok) {
+            ToLimbs(rr, m_rr52.data(), count, bytes.data());
+        } else {
+            m_path = MontKernelPath::OpenSSL;
+        }
+        BN_CTX_end(ctx);
+    }
+    
+    bool MontKernel::exp(BIGNUM* r, const BIGNUM* a, const BIGNUM* p, BN_CTX* ctx) const {
+        if (m_path == MontKernelPath::OpenSSL || BN_is_negative(p)) {
+            return ModExp(r, a, p, m_m, m_mont.get(), ctx);
+        }
+        if (BN_is_zero(p)) {
+            return BN_one(r);
+        }
+        
+#if defined(SIMPLESRP_SIMD_X86)
+        BN_CTX_start(ctx);
+        const BIGNUM* base = a;
+        if (BN_is_negative(a) || BN_ucmp(a, m_m) >= 0) {
+            BIGNUM* reduced = BN_CTX_get(ctx);
+            if (!reduced || !BN_nnmod(reduced, a, m_m, ctx)) {
+                BN_CTX_end(ctx);
+                return false;
+            }
+            base = reduced;
+        }
+        
+        const size_t count = m_vectors * 8;
+        Scratch& scratch = ThreadScratch();
+        scratch.bytes.resize(count * 8);
+        scratch.limbs.resize(2 * count + kernels::ModExp52ScratchLimbs(m_vectors));
+        uint64_t* base52 = scratch.limbs.data();
+        uint64_t* result52 = base52 + count;
+        ToLimbs(base, base52, count, scratch.bytes.data());
+        BN_CTX_end(ctx);
+        
+        const kernels::Modulus52 modulus = { m_m52.data(), m_rr52.data(), m_k0, m_limbs, m_vectors };
+        bool ok = kernels::ModExp52_AVX512IFMA(modulus, base52, p, result52, result52 + count)
+            && FromLimbs(result52, count, r, scratch.bytes.data());
+        if (ok && BN_ucmp(r, m_m) >= 0) {
+            ok = BN_usub(r, r, m_m);
+        }
+        
+        // Table entries and the result are powers of secret exponents.
+        OPENSSL_cleanse(scratch.limbs.data(), scratch.limbs.size() * sizeof(uint64_t));
+        OPENSSL_cleanse(scratch.bytes.data(), scratch.bytes.size());
+        return ok;
+#else
+        return ModExp(r, a, p, m_m, m_mont.get(), ctx);
+#endif
+    }
+    
+    MontKernelPath MontKernel::SupportedPath() {
+        static const MontKernelPath s_path = CpuSupports(MontKernelPath::AVX512IFMA) ? MontKernelPath::AVX512IFMA : MontKernelPath::OpenSSL;
+        return s_path;
+    }
+}
@@ -0,0 +1,214 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#include "montkernel_kernels.h"
+
+#include <immintrin.h>
+
+using namespace simplesrp::bn::kernels;
+
+namespace {
+    constexpr uint64_t LimbMask = (uint64_t(1) << 52) - 1;
+    
+    inline uint64_t Lane0(__m512i x) {
+        return static_cast<uint64_t>(_mm_cvtsi128_si64(_mm512_castsi512_si128(x)));
+    }
+    
+    /// Shifts limbs of `x` down by one lane across all vectors.
+    template <size_t V>
+    inline void ShiftDown(__m512i (&x)[V]) {
+        _Pragma("GCC unroll 32")
+        for (size_t v = 0; v + 1 < V; v++) {
+            x[v] = _mm512_alignr_epi64(x[v + 1], x[v], 1);
+        }
+        x[V - 1] = _mm512_alignr_epi64(_mm512_setzero_si512(), x[V - 1], 1);
+    }
+    
+    /// Writes limbs of `x` with carries propagated, so every limb is below 2^52 again.
+    template <size_t V>
+    inline void Normalize(const __m512i (&x)[V], uint64_t* r) {
+        alignas(64) uint64_t limbs[V * 8];
+        _Pragma("GCC unroll 32")
+        for (size_t v = 0; v < V; v++) {
+            _mm512_store_si512(limbs + v * 8, x[v]);
+        }
+        uint64_t carry = 0;
+        for (size_t i = 0; i < V * 8; i++) {
+            const uint64_t limb = limbs[i] + carry;
+            r[i] = limb & LimbMask;
+            carry = limb >> 52;
+        }
+    }
+    
+    /// Almost Montgomery multiplication r = a * b / R mod m, word-serial over limbs of `b`.
+    /// Inputs below 2m give a result below 2m, as 4m < R. Limbs grow by less than 2^54 per step,
+    /// so 64-bit lanes hold all 158 steps of 8192-bit numbers without intermediate carries.
+    /// Small sizes keep a*b and m*y terms in separate registers to shorten dependency chains,
+    /// large ones keep a single accumulator and read `a` and `m` from memory to avoid spills.
+    template <size_t V>
+    void Amm52(const Modulus52& mod, const uint64_t* a, const uint64_t* b, uint64_t* r) {
+        constexpr bool Split = V <= 8;
+        __m512i T[V];
+        __m512i U[Split ? V : 1];
+        _Pragma("GCC unroll 32")
+        for (size_t v = 0; v < V; v++) {
+            T[v] = _mm512_setzero_si512();
+            if constexpr (Split) {
+                U[v] = _mm512_setzero_si512();
+            }
+        }
+        
+        const uint64_t* m = mod.m;
+        for (size_t i = 0; i < mod.limbs; i++) {
+            const __m512i bi = _mm512_set1_epi64(static_cast<long long>(b[i]));
+            _Pragma("GCC unroll 32")
+            for (size_t v = 0; v < V; v++) {
+                T[v] = _mm512_madd52lo_epu64(T[v], _mm512_loadu_si512(a + v * 8), bi);
+            }
+            
+            // y makes the lowest limb divisible by 2^52, its carry moves up with the shift.
+            const uint64_t t0 = Split ? Lane0(T[0]) + Lane0(U[0]) : Lane0(T[0]);
+            const uint64_t y = (t0 * mod.k0) & LimbMask;
+            const uint64_t carry = (t0 + ((m[0] * y) & LimbMask)) >> 52;
+            const __m512i yv = _mm512_set1_epi64(static_cast<long long>(y));
+            _Pragma("GCC unroll 32")
+            for (size_t v = 0; v < V; v++) {
+                if constexpr (Split) {
+                    U[v] = _mm512_madd52lo_epu64(U[v], _mm512_loadu_si512(m + v * 8), yv);
+                } else {
+                    T[v] = _mm512_madd52lo_epu64(T[v], _mm512_loadu_si512(m + v * 8), yv);
+                }
+            }
+            
+            ShiftDown(T);
+            if constexpr (Split) {
+                ShiftDown(U);
+            }
+            T[0] = _mm512_add_epi64(T[0], _mm512_zextsi128_si512(_mm_cvtsi64_si128(static_cast<long long>(carry))));
+            
+            // High halves of the products belong one limb up, which is where the shift left them.
+            _Pragma("GCC unroll 32")
+            for (size_t v = 0; v < V; v++) {
+                T[v] = _mm512_madd52hi_epu64(T[v], _mm512_loadu_si512(a + v * 8), bi);
+                if constexpr (Split) {
+                    U[v] = _mm512_madd52hi_epu64(U[v], _mm512_loadu_si512(m + v * 8), yv);
+                } else {
+                    T[v] = _mm512_madd52hi_epu64(T[v], _mm512_loadu_si512(m + v * 8), yv);
+                }
+            }
+        }
+        
+        if constexpr (Split) {
+            _Pragma("GCC unroll 32")
+            for (size_t v = 0; v < V; v++) {
+                T[v] = _mm512_add_epi64(T[v], U[v]);
+            }
+        }
+        Normalize(T, r);
+    }
+    
+    /// Copies `table[index]` reading every entry, so memory access does not depend on `index`.
+    template <size_t V>
+    void Gather(const uint64_t* table, size_t entries, size_t index, uint64_t* r) {
+        __m512i x[V];
+        _Pragma("GCC unroll 32")
+        for (size_t v = 0; v < V; v++) {
+            x[v] = _mm512_setzero_si512();
+        }
+        
+        const __m512i wanted = _mm512_set1_epi64(static_cast<long long>(index));
+        for (size_t i = 0; i < entries; i++) {
+            const __mmask8 mask = _mm512_cmpeq_epi64_mask(_mm512_set1_epi64(static_cast<long long>(i)), wanted);
+            _Pragma("GCC unroll 32")
+            for (size_t v = 0; v < V; v++) {
+                x[v] = _mm512_mask_mov_epi64(x[v], mask, _mm512_loadu_si512(table + (i * V + v) * 8));
+            }
+        }
+        
+        _Pragma("GCC unroll 32")
+        for (size_t v = 0; v < V; v++) {
+            _mm512_storeu_si512(r + v * 8, x[v]);
+        }
+    }
+    
+    /// Window size in bits for an exponent of `bits` bits, as OpenSSL chooses it.
+    int WindowBits(int bits) {
+        return bits > 671 ? 6 : bits > 239 ? 5 : bits > 79 ? 4 : bits > 23 ? 3 : 1;
+    }
+    
+    template <size_t V>
+    void ModExp(const Modulus52& mod, const uint64_t* a, const BIGNUM* p, uint64_t* r, uint64_t* scratch) {
+        constexpr size_t Limbs = V * 8;
+        const int bits = BN_num_bits(p);
+        const int window = WindowBits(bits);
+        const size_t entries = size_t(1) << window;
+        
+        uint64_t* table = scratch;
+        uint64_t* one = table + entries * Limbs;
+        uint64_t* factor = one + Limbs;
+        
+        // table[i] = a^i in Montgomery form.
+        for (size_t i = 0; i < Limbs; i++) {
+            one[i] = i == 0;
+        }
+        Amm52<V>(mod, one, mod.rr, table);
+        Amm52<V>(mod, a, mod.rr, table + Limbs);
+        for (size_t i = 2; i < entries; i++) {
+            Amm52<V>(mod, table + (i - 1) * Limbs, table + Limbs, table + i * Limbs);
+        }
+        
+        const int windows = (bits + window - 1) / window;
+        for (int w = windows - 1; w >= 0; w--) {
+            size_t index = 0;
+            for (int bit = window - 1; bit >= 0; bit--) {
+                index = (index << 1) | static_cast<size_t>(BN_is_bit_set(p, w * window + bit));
+            }
+            
+            if (w == windows - 1) {
+                Gather<V>(table, entries, index, r);
+                continue;
+            }
+            for (int i = 0; i < window; i++) {
+                Amm52<V>(mod, r, r, r);
+            }
+            Gather<V>(table, entries, index, factor);
+            Amm52<V>(mod, r, factor, r);
+        }
+        
+        // Out of Montgomery form: a * 1 / R is at most m.
+        Amm52<V>(mod, r, one, r);
+    }
+}
+
+bool simplesrp::bn::kernels::ModExp52_AVX512IFMA(const Modulus52& m, const uint64_t* a, const BIGNUM* p, uint64_t* r, uint64_t* scratch) {
+    switch (m.vectors) {
+    case 3:  ModExp<3>(m, a, p, r, scratch); return true;    // 1024 bits
+    case 4:  ModExp<4>(m, a, p, r, scratch); return true;    // 1536 bits
+    case 5:  ModExp<5>(m, a, p, r, scratch); return true;    // 2048 bits
+    case 8:  ModExp<8>(m, a, p, r, scratch); return true;    // 3072 bits
+    case 10: ModExp<10>(m, a, p, r, scratch); return true;   // 4096 bits
+    case 15: ModExp<15>(m, a, p, r, scratch); return true;   // 6144 bits
+    case 20: ModExp<20>(m, a, p, r, scratch); return true;   // 8192 bits
+    default: return false;
+    }
+}
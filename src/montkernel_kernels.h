@@ -0,0 +1,56 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#pragma once
+
+#include <openssl/bn.h>
+
+#include <cstddef>
+#include <cstdint>
+
+/// SIMD kernels of `bn::MontKernel`. Numbers are little-endian arrays of 52-bit limbs,
+/// padded with zero limbs to `vectors * 8`; Montgomery radix is R = 2^(52 * limbs).
+/// Defined only when SIMPLESRP_SIMD_X86 is set, each in a file built for its instruction set.
+namespace simplesrp::bn::kernels {
+    struct Modulus52 {
+        const uint64_t* m;
+        
+        /// R^2 mod m.
+        const uint64_t* rr;
+        
+        /// -m^-1 mod 2^52.
+        uint64_t k0;
+        
+        size_t limbs;
+        size_t vectors;
+    };
+    
+    /// Limbs of `scratch` needed by `ModExp52_AVX512IFMA`.
+    constexpr size_t ModExp52ScratchLimbs(size_t vectors) {
+        return (64 + 2) * vectors * 8;
+    }
+    
+    /// r = a^p mod m for a < m and p > 0. `r` is reduced to [0, m] only, the caller subtracts m
+    /// if needed. Returns false if `vectors` is not one of the SRP group sizes.
+    bool ModExp52_AVX512IFMA(const Modulus52& m, const uint64_t* a, const BIGNUM* p, uint64_t* r, uint64_t* scratch);
+}
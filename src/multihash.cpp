@@ -0,0 +1,271 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#include <simplesrp/multihash.h>
+#include <simplesrp/routines.h>
+
+#include "multihash_kernels.h"
+
+#include <array>
+#include <cstring>
+
+#if defined(SIMPLESRP_SIMD_X86)
+#include <cpuid.h>
+#endif
+
+using namespace simplesrp;
+
+namespace {
+    constexpr uint32_t Sha1IV[] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0 };
+    constexpr uint32_t Sha224IV[] = { 0xc1059ed8, 0x367cd507, 0x3070dd17, 0xf70e5939, 0xffc00b31, 0x68581511, 0x64f98fa7, 0xbefa4fa4 };
+    constexpr uint32_t Sha256IV[] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+    constexpr uint64_t Sha384IV[] = {
+        0xcbbb9d5dc1059ed8, 0x629a292a367cd507, 0x9159015a3070dd17, 0x152fecd8f70e5939,
+        0x67332667ffc00b31, 0x8eb44a8768581511, 0xdb0c2e0d64f98fa7, 0x47b5481dbefa4fa4,
+    };
+    constexpr uint64_t Sha512IV[] = {
+        0x6a09e667f3bcc908, 0xbb67ae8584caa73b, 0x3c6ef372fe94f82b, 0xa54ff53a5f1d36f1,
+        0x510e527fade682d1, 0x9b05688c2b3e6c1f, 0x1f83d9abfb41bd6b, 0x5be0cd19137e2179,
+    };
+    
+    constexpr size_t MaxLanes = 16;
+    constexpr size_t MaxBlockSize = 128;
+    
+    template <class Word>
+    using Kernel = void (*)(Word* state, const uint8_t* const* blocks);
+    
+    template <class Word>
+    struct Algorithm {
+        Kernel<Word> kernel;
+        size_t lanes;
+        const Word* iv;
+        size_t stateWords;
+        size_t digestSize;
+    };
+    
+    /// Runs `algorithm` over all messages, refilling each lane with the next message when it finishes.
+    template <class Word>
+    void HashLanes(const Algorithm<Word>& algorithm, size_t count, const uint8_t* const* data,
+                   const size_t* sizes, uint8_t* const* hashes) {
+        constexpr size_t BlockSize = sizeof(Word) * 16;
+        constexpr size_t LengthSize = sizeof(Word) * 2;
+        const size_t lanes = algorithm.lanes;
+        
+        struct Lane {
+            size_t message = 0;
+            size_t block = 0;
+            size_t fullBlocks = 0;
+            size_t totalBlocks = 0;
+            bool active = false;
+            uint8_t tail[2 * BlockSize];
+        };
+        
+        std::array<Lane, MaxLanes> laneStates;
+        std::array<Word, 8 * MaxLanes> state;
+        static const uint8_t s_idleBlock[MaxBlockSize] = {};
+        
+        size_t next = 0;
+        size_t active = 0;
+        auto assign = [&](size_t index) {
+            Lane& lane = laneStates[index];
+            lane.active = next < count;
+            if (!lane.active) {
+                return;
+            }
+            
+            const size_t size = sizes[next];
+            lane.message = next++;
+            lane.block = 0;
+            lane.fullBlocks = size / BlockSize;
+            
+            const size_t rest = size - lane.fullBlocks * BlockSize;
+            const size_t tailBlocks = rest + 1 + LengthSize <= BlockSize ? 1 : 2;
+            lane.totalBlocks = lane.fullBlocks + tailBlocks;
+            
+            memset(lane.tail, 0, sizeof(lane.tail));
+            if (rest) {
+                memcpy(lane.tail, data[lane.message] + lane.fullBlocks * BlockSize, rest);
+            }
+            lane.tail[rest] = 0x80;
+            const uint64_t bits = static_cast<uint64_t>(size) * 8;
+            for (size_t i = 0; i < 8; i++) {
+                lane.tail[tailBlocks * BlockSize - 1 - i] = static_cast<uint8_t>(bits >> (8 * i));
+            }
+            
+            for (size_t w = 0; w < algorithm.stateWords; w++) {
+                state[w * lanes + index] = algorithm.iv[w];
+            }
+            active++;
+        };
+        
+        for (size_t i = 0; i < lanes; i++) {
+            assign(i);
+        }
+        
+        const uint8_t* blocks[MaxLanes];
+        while (active) {
+            for (size_t i = 0; i < lanes; i++) {
+                const Lane& lane = laneStates[i];
+                if (!lane.active) {
+                    blocks[i] = s_idleBlock;
+                } else if (lane.block < lane.fullBlocks) {
+                    blocks[i] = data[lane.message] + lane.block * BlockSize;
+                } else {
+                    blocks[i] = lane.tail + (lane.block - lane.fullBlocks) * BlockSize;
+                }
+            }
+            
+            algorithm.kernel(state.data(), blocks);
+            
+            for (size_t i = 0; i < lanes; i++) {
+                Lane& lane = laneStates[i];
+                if (!lane.active || ++lane.block < lane.totalBlocks) {
+                    continue;
+                }
+                
+                uint8_t digest[8 * sizeof(Word)];
+                for (size_t w = 0; w < algorithm.stateWords; w++) {
+                    const Word word = state[w * lanes + i];
+                    for (size_t j = 0; j < sizeof(Word); j++) {
+                        digest[w * sizeof(Word) + j] = static_cast<uint8_t>(word >> (8 * (sizeof(Word) - 1 - j)));
+                    }
+                }
+                memcpy(hashes[lane.message], digest, algorithm.digestSize);
+                
+                active--;
+                assign(i);
+            }
+        }
+    }
+    
+#if defined(SIMPLESRP_SIMD_X86)
+    bool CpuHasShaExtensions() {
+        unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+        return __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx & (1u << 29));
+    }
+#endif
+    
+    bool CpuSupports(utils::MultiDigestPath path) {
+#if defined(SIMPLESRP_SIMD_X86)
+        switch (path) {
+        case utils::MultiDigestPath::AVX2:
+            return __builtin_cpu_supports("avx2");
+        case utils::MultiDigestPath::AVX512:
+            return __builtin_cpu_supports("avx512f");
+        default:
+            return true;
+        }
+#else
+        return path == utils::MultiDigestPath::Scalar;
+#endif
+    }
+}
+
+utils::MultiDigest::MultiDigest(DigestType digestType)
+: MultiDigest(digestType, SupportedPath())
+{
+#if defined(SIMPLESRP_SIMD_X86)
+    // OpenSSL with SHA extensions outruns 8 AVX2 lanes of SHA1/SHA256 (16 AVX-512 lanes do not).
+    const bool wide = digestType == DigestType::SHA384 || digestType == DigestType::SHA512;
+    if (m_path == MultiDigestPath::AVX2 && !wide && CpuHasShaExtensions()) {
+        m_path = MultiDigestPath::Scalar;
+    }
+#endif
+}
+
+utils::MultiDigest::MultiDigest(DigestType digestType, MultiDigestPath path)
+: m_digestType(digestType)
+, m_path(path)
+{
+    while (m_path != MultiDigestPath::Scalar && !CpuSupports(m_path)) {
+        m_path = static_cast<MultiDigestPath>(static_cast<int>(m_path) - 1);
+    }
+}
+
+utils::MultiDigestPath utils::MultiDigest::SupportedPath() {
+    static const MultiDigestPath s_path = [] {
+        for (auto path : { MultiDigestPath::AVX512, MultiDigestPath::AVX2 }) {
+            if (CpuSupports(path)) {
+                return path;
+            }
+        }
+        return MultiDigestPath::Scalar;
+    }();
+    return s_path;
+}
+
+utils::MultiDigestPath utils::MultiDigest::path() const {
+    return m_path;
+}
+
+size_t utils::MultiDigest::lanes() const {
+    const bool wide = m_digestType == DigestType::SHA384 || m_digestType == DigestType::SHA512;
+    switch (m_path) {
+    case MultiDigestPath::AVX2:
+        return wide ? 4 : 8;
+    case MultiDigestPath::AVX512:
+        return wide ? 8 : 16;
+    default:
+        return 1;
+    }
+}
+
+void utils::MultiDigest::hash(size_t count, const uint8_t* const* data, const size_t* sizes, uint8_t* const* hashes) const {
+    const size_t digestSize = DigestSize(m_digestType);
+    if (m_path == MultiDigestPath::Scalar || count < 2) {
+        for (size_t i = 0; i < count; i++) {
+            Digest di(m_digestType);
+            di.update(data[i], sizes[i]);
+            di.final(hashes[i]);
+        }
+        return;
+    }
+    
+#if defined(SIMPLESRP_SIMD_X86)
+    const bool avx512 = m_path == MultiDigestPath::AVX512;
+    const size_t lanes32 = avx512 ? 16 : 8;
+    const size_t lanes64 = avx512 ? 8 : 4;
+    switch (m_digestType) {
+    case DigestType::SHA1:
+        HashLanes<uint32_t>({ avx512 ? kernels::Sha1_AVX512 : kernels::Sha1_AVX2, lanes32, Sha1IV, 5, digestSize },
+                            count, data, sizes, hashes);
+        break;
+    case DigestType::SHA224:
+        HashLanes<uint32_t>({ avx512 ? kernels::Sha256_AVX512 : kernels::Sha256_AVX2, lanes32, Sha224IV, 8, digestSize },
+                            count, data, sizes, hashes);
+        break;
+    case DigestType::SHA256:
+        HashLanes<uint32_t>({ avx512 ? kernels::Sha256_AVX512 : kernels::Sha256_AVX2, lanes32, Sha256IV, 8, digestSize },
+                            count, data, sizes, hashes);
+        break;
+    case DigestType::SHA384:
+        HashLanes<uint64_t>({ avx512 ? kernels::Sha512_AVX512 : kernels::Sha512_AVX2, lanes64, Sha384IV, 8, digestSize },
+                            count, data, sizes, hashes);
+        break;
+    case DigestType::SHA512:
+        HashLanes<uint64_t>({ avx512 ? kernels::Sha512_AVX512 : kernels::Sha512_AVX2, lanes64, Sha512IV, 8, digestSize },
+                            count, data, sizes, hashes);
+        break;
+    }
+#endif
+}
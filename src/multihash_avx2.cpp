@@ -0,0 +1,75 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#include "multihash_kernels.h"
+#include "multihash_lanes.h"
+
+#include <immintrin.h>
+
+namespace {
+    struct Avx2x32 {
+        using V = __m256i;
+        using Word = uint32_t;
+        static constexpr size_t Lanes = 8;
+        
+        static V load(const Word* p) { return _mm256_loadu_si256(reinterpret_cast<const V*>(p)); }
+        static void store(Word* p, V v) { _mm256_storeu_si256(reinterpret_cast<V*>(p), v); }
+        static V set1(Word w) { return _mm256_set1_epi32(static_cast<int>(w)); }
+        static V add(V a, V b) { return _mm256_add_epi32(a, b); }
+        static V xor_(V a, V b) { return _mm256_xor_si256(a, b); }
+        template <int N> static V rotr(V x) { return _mm256_or_si256(_mm256_srli_epi32(x, N), _mm256_slli_epi32(x, 32 - N)); }
+        template <int N> static V shr(V x) { return _mm256_srli_epi32(x, N); }
+        static V ch(V e, V f, V g) { return _mm256_xor_si256(_mm256_and_si256(e, _mm256_xor_si256(f, g)), g); }
+        static V maj(V a, V b, V c) { return _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b))); }
+        static V parity(V a, V b, V c) { return _mm256_xor_si256(_mm256_xor_si256(a, b), c); }
+    };
+    
+    struct Avx2x64 {
+        using V = __m256i;
+        using Word = uint64_t;
+        static constexpr size_t Lanes = 4;
+        
+        static V load(const Word* p) { return _mm256_loadu_si256(reinterpret_cast<const V*>(p)); }
+        static void store(Word* p, V v) { _mm256_storeu_si256(reinterpret_cast<V*>(p), v); }
+        static V set1(Word w) { return _mm256_set1_epi64x(static_cast<long long>(w)); }
+        static V add(V a, V b) { return _mm256_add_epi64(a, b); }
+        static V xor_(V a, V b) { return _mm256_xor_si256(a, b); }
+        template <int N> static V rotr(V x) { return _mm256_or_si256(_mm256_srli_epi64(x, N), _mm256_slli_epi64(x, 64 - N)); }
+        template <int N> static V shr(V x) { return _mm256_srli_epi64(x, N); }
+        static V ch(V e, V f, V g) { return _mm256_xor_si256(_mm256_and_si256(e, _mm256_xor_si256(f, g)), g); }
+        static V maj(V a, V b, V c) { return _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b))); }
+        static V parity(V a, V b, V c) { return _mm256_xor_si256(_mm256_xor_si256(a, b), c); }
+    };
+}
+
+void simplesrp::utils::kernels::Sha1_AVX2(uint32_t* state, const uint8_t* const* blocks) {
+    Sha1<Avx2x32>(state, blocks);
+}
+
+void simplesrp::utils::kernels::Sha256_AVX2(uint32_t* state, const uint8_t* const* blocks) {
+    Sha256<Avx2x32>(state, blocks);
+}
+
+void simplesrp::utils::kernels::Sha512_AVX2(uint64_t* state, const uint8_t* const* blocks) {
+    Sha512<Avx2x64>(state, blocks);
+}
@@ -0,0 +1,80 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#include "multihash_kernels.h"
+#include "multihash_lanes.h"
+
+#include <immintrin.h>
+
+namespace {
+    // Ternary logic immediates: ch = (e & f) | (~e & g), maj = majority, parity = a ^ b ^ c.
+    constexpr int Ch = 0xca;
+    constexpr int Maj = 0xe8;
+    constexpr int Parity = 0x96;
+    
+    struct Avx512x32 {
+        using V = __m512i;
+        using Word = uint32_t;
+        static constexpr size_t Lanes = 16;
+        
+        static V load(const Word* p) { return _mm512_loadu_si512(p); }
+        static void store(Word* p, V v) { _mm512_storeu_si512(p, v); }
+        static V set1(Word w) { return _mm512_set1_epi32(static_cast<int>(w)); }
+        static V add(V a, V b) { return _mm512_add_epi32(a, b); }
+        static V xor_(V a, V b) { return _mm512_xor_si512(a, b); }
+        template <int N> static V rotr(V x) { return _mm512_ror_epi32(x, N); }
+        template <int N> static V shr(V x) { return _mm512_srli_epi32(x, N); }
+        static V ch(V e, V f, V g) { return _mm512_ternarylogic_epi32(e, f, g, Ch); }
+        static V maj(V a, V b, V c) { return _mm512_ternarylogic_epi32(a, b, c, Maj); }
+        static V parity(V a, V b, V c) { return _mm512_ternarylogic_epi32(a, b, c, Parity); }
+    };
+    
+    struct Avx512x64 {
+        using V = __m512i;
+        using Word = uint64_t;
+        static constexpr size_t Lanes = 8;
+        
+        static V load(const Word* p) { return _mm512_loadu_si512(p); }
+        static void store(Word* p, V v) { _mm512_storeu_si512(p, v); }
+        static V set1(Word w) { return _mm512_set1_epi64(static_cast<long long>(w)); }
+        static V add(V a, V b) { return _mm512_add_epi64(a, b); }
+        static V xor_(V a, V b) { return _mm512_xor_si512(a, b); }
+        template <int N> static V rotr(V x) { return _mm512_ror_epi64(x, N); }
+        template <int N> static V shr(V x) { return _mm512_srli_epi64(x, N); }
+        static V ch(V e, V f, V g) { return _mm512_ternarylogic_epi64(e, f, g, Ch); }
+        static V maj(V a, V b, V c) { return _mm512_ternarylogic_epi64(a, b, c, Maj); }
+        static V parity(V a, V b, V c) { return _mm512_ternarylogic_epi64(a, b, c, Parity); }
+    };
+}
+
+void simplesrp::utils::kernels::Sha1_AVX512(uint32_t* state, const uint8_t* const* blocks) {
+    Sha1<Avx512x32>(state, blocks);
+}
+
+void simplesrp::utils::kernels::Sha256_AVX512(uint32_t* state, const uint8_t* const* blocks) {
+    Sha256<Avx512x32>(state, blocks);
+}
+
+void simplesrp::utils::kernels::Sha512_AVX512(uint64_t* state, const uint8_t* const* blocks) {
+    Sha512<Avx512x64>(state, blocks);
+}
@@ -0,0 +1,40 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/// SIMD block functions of `utils::MultiDigest`. Each compresses one block of every lane.
+/// `state` is word-major: word `w` of lane `l` is `state[w * lanes + l]`.
+/// Defined only when SIMPLESRP_SIMD_X86 is set, each in a file built for its instruction set.
+namespace simplesrp::utils::kernels {
+    void Sha1_AVX2(uint32_t* state, const uint8_t* const* blocks);     // 8 lanes
+    void Sha256_AVX2(uint32_t* state, const uint8_t* const* blocks);   // 8 lanes
+    void Sha512_AVX2(uint64_t* state, const uint8_t* const* blocks);   // 4 lanes
+    
+    void Sha1_AVX512(uint32_t* state, const uint8_t* const* blocks);   // 16 lanes
+    void Sha256_AVX512(uint32_t* state, const uint8_t* const* blocks); // 16 lanes
+    void Sha512_AVX512(uint64_t* state, const uint8_t* const* blocks); // 8 lanes
+}
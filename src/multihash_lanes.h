@@ -0,0 +1,189 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/// SHA compression functions written against a SIMD traits type `T`:
+/// `V` (vector), `Word`, `Lanes`, `load`, `store`, `set1`, `add`, `xor_`, `rotr<N>`, `shr<N>`,
+/// `ch`, `maj`, `parity`. Included only by files built for a specific instruction set,
+/// hence the unnamed namespace: nothing here may be shared with code built without it.
+namespace {
+    inline uint32_t LoadBE(const uint8_t* p, uint32_t) {
+        return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+    }
+    
+    inline uint64_t LoadBE(const uint8_t* p, uint64_t) {
+        return (uint64_t(LoadBE(p, uint32_t())) << 32) | LoadBE(p + 4, uint32_t());
+    }
+    
+    /// Word `index` of every lane's block, as a vector.
+    template <class T>
+    typename T::V LoadMessageWord(const uint8_t* const* blocks, size_t index) {
+        using Word = typename T::Word;
+        alignas(64) Word words[T::Lanes];
+        for (size_t lane = 0; lane < T::Lanes; lane++) {
+            words[lane] = LoadBE(blocks[lane] + index * sizeof(Word), Word());
+        }
+        return T::load(words);
+    }
+    
+    template <class T>
+    void Sha1(uint32_t* state, const uint8_t* const* blocks) {
+        using V = typename T::V;
+        
+        V w[16];
+        for (size_t t = 0; t < 16; t++) {
+            w[t] = LoadMessageWord<T>(blocks, t);
+        }
+        
+        V a = T::load(state + 0 * T::Lanes);
+        V b = T::load(state + 1 * T::Lanes);
+        V c = T::load(state + 2 * T::Lanes);
+        V d = T::load(state + 3 * T::Lanes);
+        V e = T::load(state + 4 * T::Lanes);
+        
+        for (size_t t = 0; t < 80; t++) {
+            if (t >= 16) {
+                const V x = T::xor_(T::xor_(w[(t - 3) & 15], w[(t - 8) & 15]), T::xor_(w[(t - 14) & 15], w[t & 15]));
+                w[t & 15] = T::template rotr<31>(x);
+            }
+            
+            V f, k;
+            if (t < 20) {
+                f = T::ch(b, c, d);
+                k = T::set1(0x5a827999);
+            } else if (t < 40) {
+                f = T::parity(b, c, d);
+                k = T::set1(0x6ed9eba1);
+            } else if (t < 60) {
+                f = T::maj(b, c, d);
+                k = T::set1(0x8f1bbcdc);
+            } else {
+                f = T::parity(b, c, d);
+                k = T::set1(0xca62c1d6);
+            }
+            
+            const V temp = T::add(T::add(T::template rotr<27>(a), f), T::add(T::add(e, k), w[t & 15]));
+            e = d;
+            d = c;
+            c = T::template rotr<2>(b);
+            b = a;
+            a = temp;
+        }
+        
+        T::store(state + 0 * T::Lanes, T::add(a, T::load(state + 0 * T::Lanes)));
+        T::store(state + 1 * T::Lanes, T::add(b, T::load(state + 1 * T::Lanes)));
+        T::store(state + 2 * T::Lanes, T::add(c, T::load(state + 2 * T::Lanes)));
+        T::store(state + 3 * T::Lanes, T::add(d, T::load(state + 3 * T::Lanes)));
+        T::store(state + 4 * T::Lanes, T::add(e, T::load(state + 4 * T::Lanes)));
+    }
+    
+    constexpr uint32_t Sha256K[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+    };
+    
+    constexpr uint64_t Sha512K[80] = {
+        0x428a2f98d728ae22, 0x7137449123ef65cd, 0xb5c0fbcfec4d3b2f, 0xe9b5dba58189dbbc, 0x3956c25bf348b538,
+        0x59f111f1b605d019, 0x923f82a4af194f9b, 0xab1c5ed5da6d8118, 0xd807aa98a3030242, 0x12835b0145706fbe,
+        0x243185be4ee4b28c, 0x550c7dc3d5ffb4e2, 0x72be5d74f27b896f, 0x80deb1fe3b1696b1, 0x9bdc06a725c71235,
+        0xc19bf174cf692694, 0xe49b69c19ef14ad2, 0xefbe4786384f25e3, 0x0fc19dc68b8cd5b5, 0x240ca1cc77ac9c65,
+        0x2de92c6f592b0275, 0x4a7484aa6ea6e483, 0x5cb0a9dcbd41fbd4, 0x76f988da831153b5, 0x983e5152ee66dfab,
+        0xa831c66d2db43210, 0xb00327c898fb213f, 0xbf597fc7beef0ee4, 0xc6e00bf33da88fc2, 0xd5a79147930aa725,
+        0x06ca6351e003826f, 0x142929670a0e6e70, 0x27b70a8546d22ffc, 0x2e1b21385c26c926, 0x4d2c6dfc5ac42aed,
+        0x53380d139d95b3df, 0x650a73548baf63de, 0x766a0abb3c77b2a8, 0x81c2c92e47edaee6, 0x92722c851482353b,
+        0xa2bfe8a14cf10364, 0xa81a664bbc423001, 0xc24b8b70d0f89791, 0xc76c51a30654be30, 0xd192e819d6ef5218,
+        0xd69906245565a910, 0xf40e35855771202a, 0x106aa07032bbd1b8, 0x19a4c116b8d2d0c8, 0x1e376c085141ab53,
+        0x2748774cdf8eeb99, 0x34b0bcb5e19b48a8, 0x391c0cb3c5c95a63, 0x4ed8aa4ae3418acb, 0x5b9cca4f7763e373,
+        0x682e6ff3d6b2b8a3, 0x748f82ee5defb2fc, 0x78a5636f43172f60, 0x84c87814a1f0ab72, 0x8cc702081a6439ec,
+        0x90befffa23631e28, 0xa4506cebde82bde9, 0xbef9a3f7b2c67915, 0xc67178f2e372532b, 0xca273eceea26619c,
+        0xd186b8c721c0c207, 0xeada7dd6cde0eb1e, 0xf57d4f7fee6ed178, 0x06f067aa72176fba, 0x0a637dc5a2c898a6,
+        0x113f9804bef90dae, 0x1b710b35131c471b, 0x28db77f523047d84, 0x32caab7b40c72493, 0x3c9ebe0a15c9bebc,
+        0x431d67c49c100d4c, 0x4cc5d4becb3e42b6, 0x597f299cfc657e2a, 0x5fcb6fab3ad6faec, 0x6c44198c4a475817,
+    };
+    
+    /// SHA-256 and SHA-512 differ only in word size, rotation amounts and constants.
+    template <class T, int S0, int S1, int S2, int S3, int S4, int S5,
+              int s0, int s1, int s2, int s3, int s4, int s5, size_t Rounds, class K>
+    void Sha2(typename T::Word* state, const uint8_t* const* blocks, const K& constants) {
+        using V = typename T::V;
+        
+        V w[16];
+        for (size_t t = 0; t < 16; t++) {
+            w[t] = LoadMessageWord<T>(blocks, t);
+        }
+        
+        V s[8];
+        for (size_t i = 0; i < 8; i++) {
+            s[i] = T::load(state + i * T::Lanes);
+        }
+        V a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+        
+        for (size_t t = 0; t < Rounds; t++) {
+            if (t >= 16) {
+                const V w15 = w[(t - 15) & 15];
+                const V w2 = w[(t - 2) & 15];
+                const V sigma0 = T::xor_(T::xor_(T::template rotr<s0>(w15), T::template rotr<s1>(w15)), T::template shr<s2>(w15));
+                const V sigma1 = T::xor_(T::xor_(T::template rotr<s3>(w2), T::template rotr<s4>(w2)), T::template shr<s5>(w2));
+                w[t & 15] = T::add(T::add(w[t & 15], sigma0), T::add(w[(t - 7) & 15], sigma1));
+            }
+            
+            const V sum1 = T::xor_(T::xor_(T::template rotr<S3>(e), T::template rotr<S4>(e)), T::template rotr<S5>(e));
+            const V t1 = T::add(T::add(h, sum1), T::add(T::ch(e, f, g), T::add(T::set1(constants[t]), w[t & 15])));
+            const V sum0 = T::xor_(T::xor_(T::template rotr<S0>(a), T::template rotr<S1>(a)), T::template rotr<S2>(a));
+            const V t2 = T::add(sum0, T::maj(a, b, c));
+            h = g;
+            g = f;
+            f = e;
+            e = T::add(d, t1);
+            d = c;
+            c = b;
+            b = a;
+            a = T::add(t1, t2);
+        }
+        
+        const V result[8] = { a, b, c, d, e, f, g, h };
+        for (size_t i = 0; i < 8; i++) {
+            T::store(state + i * T::Lanes, T::add(s[i], result[i]));
+        }
+    }
+    
+    template <class T>
+    void Sha256(uint32_t* state, const uint8_t* const* blocks) {
+        Sha2<T, 2, 13, 22, 6, 11, 25, 7, 18, 3, 17, 19, 10, 64>(state, blocks, Sha256K);
+    }
+    
+    template <class T>
+    void Sha512(uint64_t* state, const uint8_t* const* blocks) {
+        Sha2<T, 28, 34, 39, 14, 18, 41, 1, 8, 7, 19, 61, 6, 80>(state, blocks, Sha512K);
+    }
+}
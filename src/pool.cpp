@@ -0,0 +1,108 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#include <simplesrp/pool.h>
+
+#include <algorithm>
+
+using namespace simplesrp;
+
+SRPEphemeralPool::SRPEphemeralPool(const SRPParams& params, const SRPRoutines& routines,
+                                   size_t lowWatermark, size_t highWatermark)
+: m_params(params)
+, m_routines(routines)
+, m_lowWatermark(std::min(lowWatermark, highWatermark))
+, m_highWatermark(highWatermark)
+, m_thread(&SRPEphemeralPool::refill, this)
+{}
+
+SRPEphemeralPool::~SRPEphemeralPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    m_thread.join();
+}
+
+void SRPEphemeralPool::prefill() {
+    while (size() < m_highWatermark) {
+        auto pair = generate();
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_pairs.push_back(std::move(pair));
+    }
+}
+
+bool SRPEphemeralPool::take(bn::BignumPtr& b, bn::BignumPtr& gb) {
+    std::unique_lock<std::mutex> lock(m_lock);
+    if (m_pairs.empty()) {
+        lock.unlock();
+        m_cv.notify_one();
+        return false;
+    }
+    
+    b = std::move(m_pairs.front().first);
+    gb = std::move(m_pairs.front().second);
+    m_pairs.pop_front();
+    const bool low = m_pairs.size() < m_lowWatermark;
+    lock.unlock();
+    
+    if (low) {
+        m_cv.notify_one();
+    }
+    return true;
+}
+
+bool SRPEphemeralPool::matches(const SRPParams& params) const {
+    return m_params.gn == params.gn && m_params.ephemeralBits == params.ephemeralBits;
+}
+
+size_t SRPEphemeralPool::size() const {
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_pairs.size();
+}
+
+std::pair<bn::BignumPtr, bn::BignumPtr> SRPEphemeralPool::generate() const {
+    auto b = m_routines.randomBN(m_params);
+    auto gb = m_routines.calculate_A(m_params, b.get());
+    return { b, gb };
+}
+
+void SRPEphemeralPool::refill() {
+    std::unique_lock<std::mutex> lock(m_lock);
+    while (!m_stop) {
+        const size_t size = m_pairs.size();
+        if (size >= m_highWatermark || (size >= m_lowWatermark && size > 0)) {
+            m_cv.wait(lock);
+            continue;
+        }
+        
+        // Generate without holding the lock so `take` is never blocked by exponentiation.
+        while (!m_stop && m_pairs.size() < m_highWatermark) {
+            lock.unlock();
+            auto pair = generate();
+            lock.lock();
+            m_pairs.push_back(std::move(pair));
+        }
+    }
+}
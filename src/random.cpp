@@ -0,0 +1,154 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#include <simplesrp/random.h>
+
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+using namespace simplesrp;
+
+namespace {
+    constexpr size_t KeySize = 32;
+    constexpr size_t IVSize = 16;
+    constexpr size_t BlockSize = 4096;
+    
+    using CipherContextPtr = std::unique_ptr<EVP_CIPHER_CTX, decltype(&EVP_CIPHER_CTX_free)>;
+    
+    /// Incremented in the child after each `fork`: states seeded before it must not be used again.
+    std::atomic<uint64_t> g_forkGeneration = 0;
+    
+    uint64_t ForkGeneration() {
+#ifndef _WIN32
+        static std::once_flag s_once;
+        std::call_once(s_once, [] {
+            pthread_atfork(nullptr, nullptr, [] { g_forkGeneration++; });
+        });
+#endif
+        return g_forkGeneration.load(std::memory_order_relaxed);
+    }
+    
+    class Drbg {
+    public:
+        Drbg() {
+            // The cipher is fetched once: re-keying with it set does not allocate.
+            if (m_ctx && EVP_EncryptInit_ex(m_ctx.get(), EVP_chacha20(), nullptr, nullptr, nullptr) != 1) {
+                m_ctx.reset();
+            }
+        }
+        
+        ~Drbg() {
+            OPENSSL_cleanse(m_key, sizeof(m_key));
+            OPENSSL_cleanse(m_block, sizeof(m_block));
+        }
+        
+        bool generate(uint8_t* out, size_t size) {
+            // Buffered output of the parent must not be repeated in the child.
+            if (m_seeded && m_generation != ForkGeneration()) {
+                reseedLater();
+            }
+            
+            while (size) {
+                if (m_offset == BlockSize && !refill()) {
+                    return false;
+                }
+                
+                const size_t chunk = std::min(size, BlockSize - m_offset);
+                memcpy(out, m_block + m_offset, chunk);
+                OPENSSL_cleanse(m_block + m_offset, chunk);
+                m_offset += chunk;
+                out += chunk;
+                size -= chunk;
+            }
+            return true;
+        }
+        
+        void reseedLater() {
+            m_seeded = false;
+            OPENSSL_cleanse(m_block, sizeof(m_block));
+            m_offset = BlockSize;
+        }
+        
+    private:
+        bool refill() {
+            const uint64_t generation = ForkGeneration();
+            if (!m_seeded || m_generation != generation || m_output >= utils::RandomReseedInterval) {
+                if (RAND_priv_bytes(m_key, sizeof(m_key)) != 1) {
+                    return false;
+                }
+                m_seeded = true;
+                m_generation = generation;
+                m_output = 0;
+            }
+            
+            // Keystream of the current key: the first KeySize bytes replace the key,
+            // so output handed out earlier cannot be recomputed from the state.
+            static const uint8_t s_iv[IVSize] = {};
+            uint8_t stream[KeySize + BlockSize] = {};
+            int length = 0;
+            const bool ok = m_ctx
+                && EVP_EncryptInit_ex(m_ctx.get(), nullptr, nullptr, m_key, s_iv) == 1
+                && EVP_EncryptUpdate(m_ctx.get(), stream, &length, stream, static_cast<int>(sizeof(stream))) == 1;
+            if (ok) {
+                memcpy(m_key, stream, KeySize);
+                memcpy(m_block, stream + KeySize, BlockSize);
+                m_offset = 0;
+                m_output += BlockSize;
+            }
+            OPENSSL_cleanse(stream, sizeof(stream));
+            return ok;
+        }
+        
+    private:
+        CipherContextPtr m_ctx = CipherContextPtr(EVP_CIPHER_CTX_new(), &EVP_CIPHER_CTX_free);
+        uint8_t m_key[KeySize] = {};
+        uint8_t m_block[BlockSize] = {};
+        size_t m_offset = BlockSize;
+        size_t m_output = 0;
+        uint64_t m_generation = 0;
+        bool m_seeded = false;
+    };
+    
+    Drbg& ThreadDrbg() {
+        thread_local Drbg s_drbg;
+        return s_drbg;
+    }
+}
+
+bool utils::RandomBytes(void* ptr, size_t size) {
+    return ThreadDrbg().generate(static_cast<uint8_t*>(ptr), size);
+}
+
+void utils::ReseedRandom() {
+    ThreadDrbg().reseedLater();
+}
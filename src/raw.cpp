@@ -0,0 +1,261 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#include <simplesrp/raw.h>
+#include <simplesrp/core.h>
+#include <simplesrp/group.h>
+
+using namespace simplesrp;
+
+namespace {
+    bool WriteBignum(const BIGNUM* bn, size_t size, uint8_t* out, size_t outSize) {
+        return outSize >= size && BN_bn2binpad(bn, out, static_cast<int>(size)) >= 0;
+    }
+}
+
+// === SRPRawClient ===
+
+SRPRawClient::SRPRawClient(DigestType digestType, SRPBits srpBits)
+: params(CreateParams(digestType, srpBits))
+, m_a(bn::New())
+, m_A(bn::New())
+, m_B(bn::New())
+, m_u(bn::New())
+, m_x(bn::New())
+, m_S(bn::New())
+, m_scratch(BN_num_bytes(params.gn->N))
+{}
+
+size_t SRPRawClient::bignumSize() const {
+    return BN_num_bytes(params.gn->N);
+}
+
+size_t SRPRawClient::digestSize() const {
+    return DigestSize(params.digestType);
+}
+
+uint8_t* SRPRawClient::scratch() {
+    if (m_scratch.size() < bignumSize()) {
+        m_scratch.resize(bignumSize());
+    }
+    return m_scratch.data();
+}
+
+bool SRPRawClient::startAuthentication(uint8_t* A, size_t ASize) {
+    return insecure_startAuthentication(nullptr, 0, A, ASize);
+}
+
+bool SRPRawClient::insecure_startAuthentication(const uint8_t* a, size_t aSize, uint8_t* A, size_t ASize) {
+    m_hasKey = false;
+    
+    const size_t ephemeralBits = core::EphemeralBits(params);
+    if (!a || !aSize || !BN_bin2bn(a, static_cast<int>(aSize), m_a.get())
+        || static_cast<size_t>(BN_num_bytes(m_a.get())) != (ephemeralBits + 7) / 8) {
+        if (!bn::RandomBits(m_a.get(), ephemeralBits)) {
+            return false;
+        }
+    }
+    
+    const SRPGroup& group = SRPGroup::Get(params);
+    return core::Calculate_A(group, m_a.get(), m_A.get(), bn::ThreadContext())
+        && WriteBignum(m_A.get(), group.bignumSize, A, ASize);
+}
+
+bool SRPRawClient::processChallenge(const char* username, size_t usernameSize,
+                                    const char* password, size_t passwordSize,
+                                    const uint8_t* salt, size_t saltSize,
+                                    const uint8_t* B, size_t BSize,
+                                    uint8_t* M1, size_t& M1Size) {
+    m_hasKey = false;
+    
+    const SRPGroup& group = SRPGroup::Get(params);
+    const size_t hashSize = digestSize();
+    BN_CTX* ctx = bn::ThreadContext();
+    
+    if (!BN_bin2bn(B, static_cast<int>(BSize), m_B.get())) {
+        return false;
+    }
+    
+    uint8_t hash[SHA512_DIGEST_LENGTH];
+    core::Calculate_u(group, m_A.get(), m_B.get(), scratch(), hash);
+    BN_bin2bn(hash, static_cast<int>(hashSize), m_u.get());
+    if (!core::ClientSafetyCheck(m_B.get(), m_u.get())) {
+        return false;
+    }
+    
+    core::Calculate_x(group, username, usernameSize, password, passwordSize, salt, saltSize, hash);
+    BN_bin2bn(hash, static_cast<int>(hashSize), m_x.get());
+    
+    if (!core::ClientPremaster(group, m_u.get(), m_x.get(), group.k.get(), m_a.get(), m_B.get(), m_S.get(), ctx)) {
+        return false;
+    }
+    core::Calculate_K(group, m_S.get(), scratch(), m_K);
+    
+    utils::Digest di = core::BeginM1(group, username, usernameSize, salt, saltSize);
+    core::FinishM1(group, di, m_A.get(), m_B.get(), m_K, hashSize, scratch(), hash);
+    core::Calculate_M2(group, m_A.get(), hash, hashSize, m_K, hashSize, scratch(), m_M2);
+    
+    M1Size = core::CopyStripped(hash, hashSize, M1, M1Size);
+    m_hasKey = M1Size > 0;
+    return m_hasKey;
+}
+
+bool SRPRawClient::verifySession(const uint8_t* M2, size_t M2Size) const {
+    return m_hasKey && core::EqualStripped(m_M2, digestSize(), M2, M2Size);
+}
+
+bool SRPRawClient::processChallenge(const char* username, size_t usernameSize,
+                                    const char* password, size_t passwordSize,
+                                    const SRPServerChallengeView& challenge,
+                                    uint8_t* M1, size_t& M1Size) {
+    return processChallenge(username, usernameSize, password, passwordSize,
+                            challenge.salt.data, challenge.salt.size, challenge.B.data, challenge.B.size, M1, M1Size);
+}
+
+bool SRPRawClient::verifySession(const SRPProofView& M2) const {
+    return verifySession(M2.M.data, M2.M.size);
+}
+
+size_t SRPRawClient::sessionKey(uint8_t* K, size_t KSize) const {
+    return m_hasKey ? core::CopyStripped(m_K, digestSize(), K, KSize) : 0;
+}
+
+// === SRPRawServer ===
+
+SRPRawServer::SRPRawServer(DigestType digestType, SRPBits srpBits)
+: params(CreateParams(digestType, srpBits))
+, m_v(bn::New())
+, m_b(bn::New())
+, m_B(bn::New())
+, m_A(bn::New())
+, m_u(bn::New())
+, m_S(bn::New())
+, m_kv(bn::New())
+, m_scratch(BN_num_bytes(params.gn->N))
+, m_M1Prefix(digestType)
+{}
+
+size_t SRPRawServer::bignumSize() const {
+    return BN_num_bytes(params.gn->N);
+}
+
+size_t SRPRawServer::digestSize() const {
+    return DigestSize(params.digestType);
+}
+
+uint8_t* SRPRawServer::scratch() {
+    if (m_scratch.size() < bignumSize()) {
+        m_scratch.resize(bignumSize());
+    }
+    return m_scratch.data();
+}
+
+bool SRPRawServer::startAuthentication(const char* username, size_t usernameSize,
+                                       const uint8_t* salt, size_t saltSize,
+                                       const uint8_t* verifier, size_t verifierSize,
+                                       uint8_t* B, size_t BSize) {
+    return startAuthentication(username, usernameSize, salt, saltSize, verifier, verifierSize, nullptr, 0, B, BSize);
+}
+
+bool SRPRawServer::startAuthentication(const char* username, size_t usernameSize,
+                                       const uint8_t* salt, size_t saltSize,
+                                       const uint8_t* verifier, size_t verifierSize,
+                                       const uint8_t* kv, size_t kvSize,
+                                       uint8_t* B, size_t BSize) {
+    m_started = false;
+    m_hasKey = false;
+    
+    const SRPGroup& group = SRPGroup::Get(params);
+    BN_CTX* ctx = bn::ThreadContext();
+    
+    // m_S holds g^b until the premaster secret is computed.
+    if (!BN_bin2bn(verifier, static_cast<int>(verifierSize), m_v.get())
+        || !bn::RandomBits(m_b.get(), core::EphemeralBits(params))
+        || !core::Calculate_A(group, m_b.get(), m_S.get(), ctx)) {
+        return false;
+    }
+    
+    const bool combined = kv
+        ? BN_bin2bn(kv, static_cast<int>(kvSize), m_kv.get()) && bn::Compare(m_kv.get(), group.gn->N) < 0
+            && core::CombineKV_B(group, m_S.get(), m_kv.get(), m_B.get(), ctx)
+        : core::Combine_B(group, m_S.get(), m_v.get(), group.k.get(), m_B.get(), ctx);
+    if (!combined || !WriteBignum(m_B.get(), group.bignumSize, B, BSize)) {
+        return false;
+    }
+    
+    m_M1Prefix = core::BeginM1(group, username, usernameSize, salt, saltSize);
+    m_started = true;
+    return true;
+}
+
+bool SRPRawServer::verifySession(const uint8_t* A, size_t ASize,
+                                 const uint8_t* M1, size_t M1Size,
+                                 uint8_t* M2, size_t& M2Size) {
+    m_hasKey = false;
+    if (!m_started) {
+        return false;
+    }
+    
+    const SRPGroup& group = SRPGroup::Get(params);
+    const size_t hashSize = digestSize();
+    BN_CTX* ctx = bn::ThreadContext();
+    
+    if (!BN_bin2bn(A, static_cast<int>(ASize), m_A.get()) || !core::ServerSafetyCheck(group, m_A.get(), ctx)) {
+        return false;
+    }
+    
+    uint8_t hash[SHA512_DIGEST_LENGTH];
+    core::Calculate_u(group, m_A.get(), m_B.get(), scratch(), hash);
+    BN_bin2bn(hash, static_cast<int>(hashSize), m_u.get());
+    if (!core::ServerPremaster(group, m_u.get(), m_v.get(), m_b.get(), m_A.get(), m_S.get(), ctx)) {
+        return false;
+    }
+    core::Calculate_K(group, m_S.get(), scratch(), m_K);
+    
+    utils::Digest di = m_M1Prefix;
+    core::FinishM1(group, di, m_A.get(), m_B.get(), m_K, hashSize, scratch(), hash);
+    if (!core::EqualStripped(hash, hashSize, M1, M1Size)) {
+        return false;
+    }
+    
+    uint8_t serverM2[SHA512_DIGEST_LENGTH];
+    core::Calculate_M2(group, m_A.get(), hash, hashSize, m_K, hashSize, scratch(), serverM2);
+    M2Size = core::CopyStripped(serverM2, hashSize, M2, M2Size);
+    m_hasKey = M2Size > 0;
+    return m_hasKey;
+}
+
+bool SRPRawServer::startAuthentication(const SRPClientHelloView& hello,
+                                       const uint8_t* salt, size_t saltSize,
+                                       const uint8_t* verifier, size_t verifierSize,
+                                       uint8_t* B, size_t BSize) {
+    return startAuthentication(hello.username, hello.usernameSize, salt, saltSize, verifier, verifierSize, B, BSize);
+}
+
+bool SRPRawServer::verifySession(SRPBytesView A, const SRPProofView& M1, uint8_t* M2, size_t& M2Size) {
+    return verifySession(A.data, A.size, M1.M.data, M1.M.size, M2, M2Size);
+}
+
+size_t SRPRawServer::sessionKey(uint8_t* K, size_t KSize) const {
+    return m_hasKey ? core::CopyStripped(m_K, digestSize(), K, KSize) : 0;
+}
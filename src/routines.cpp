@@ -21,183 +21,165 @@
 //  SOFTWARE.
 
 #include <simplesrp/routines.h>
+#include <simplesrp/core.h>
+#include <simplesrp/group.h>
+#include <simplesrp/metrics.h>
+#include <simplesrp/threadpool.h>
 
-#if defined(_MSC_VER)
-#define SSRP_DISABLE_DEPRECATION_WARNINGS \
-    __pragma(warning(push)) \
-    __pragma(warning(disable : 4996))
-#define SSRP_ENABLE_DEPRECATION_WARNINGS \
-    __pragma(warning(pop))
-
-#elif defined(__GNUC__) || defined(__clang__)
-#define SSRP_DISABLE_DEPRECATION_WARNINGS \
-    _Pragma("GCC diagnostic push") \
-    _Pragma("GCC diagnostic ignored \"-Wdeprecated-declarations\"")
-#define SSRP_ENABLE_DEPRECATION_WARNINGS \
-    _Pragma("GCC diagnostic pop")
-
-#else
-#define SSRP_DISABLE_DEPRECATION_WARNINGS
-#define SSRP_ENABLE_DEPRECATION_WARNINGS
-#endif
+#include <algorithm>
 
 namespace {
     using namespace simplesrp;
     
-    size_t MinBignumSize(const SRPParams& params, Flags flag) {
-        return (params.flags & flag) ? 0 : BN_num_bytes(params.gn->N);
-    }
-    
     bn::BignumPtr RandomBN(const SRPParams& params) {
-        return bn::Random(BN_num_bytes(params.gn->N));
+        return bn::RandomBits(core::EphemeralBits(params));
     }
     
     bn::BignumPtr Calculate_A(const SRPParams& params, const BIGNUM* a) {
         auto A = bn::New();
-        auto ctx = bn::MakeContext();
-        BN_mod_exp(A.get(), params.gn->g, a, params.gn->N, ctx.get());
+        core::Calculate_A(SRPGroup::Get(params), a, A.get(), bn::ThreadContext());
         
         return A;
     }
     
-    bn::BignumPtr Calculate_B(const SRPParams& params, const BIGNUM* b, const BIGNUM* v, const BIGNUM* k) {
-        auto tmp1 = bn::New();
-        auto tmp2 = bn::New();
+    bn::BignumPtr Combine_B(const SRPParams& params, const BIGNUM* gb, const BIGNUM* v, const BIGNUM* k) {
         auto B = bn::New();
-        
-        auto ctx = bn::MakeContext();
-
-        /* B = kv + g^b */
-        BN_mul(tmp1.get(), k, v, ctx.get());
-        BN_mod_exp(tmp2.get(), params.gn->g, b, params.gn->N, ctx.get());
-        BN_mod_add(B.get(), tmp1.get(), tmp2.get(), params.gn->N, ctx.get());
+        core::Combine_B(SRPGroup::Get(params), gb, v, k, B.get(), bn::ThreadContext());
 
         return B;
     }
     
-    bn::BignumPtr Calculate_k(const SRPParams& params) {
-        const size_t bnSize = MinBignumSize(params, SRPFlagSkipZeroes_k_U_X);
-        auto result = utils::Digest(params.digestType).hash({
-            bn::ToBytes(params.gn->N, bnSize),
-            bn::ToBytes(params.gn->g, bnSize),
-        });
-        return bn::FromBytes(result);
+    bn::BignumPtr CombineKV_B(const SRPParams& params, const BIGNUM* gb, const BIGNUM* kv) {
+        auto B = bn::New();
+        core::CombineKV_B(SRPGroup::Get(params), gb, kv, B.get(), bn::ThreadContext());
+        
+        return B;
     }
     
-    bn::BignumPtr Calculate_x(const SRPParams& params, const std::string& username, const std::string& password, const Buffer& salt) {
-        utils::Digest di(params.digestType);
-        if (!(params.flags & SRPFlagNoUsernameInX)) {
-            di.update(username);
+    bn::BignumPtr Calculate_B(const SRPParams& params, const BIGNUM* b, const BIGNUM* v, const BIGNUM* k) {
+        auto gb = Calculate_A(params, b);
+        return Combine_B(params, gb.get(), v, k);
+    }
+    
+    bn::BignumPtr FixedBase_A(const SRPParams& params, const BIGNUM* a, size_t combTeeth) {
+        const SRPGroup& group = SRPGroup::Get(params);
+        auto table = group.fixedBaseTable(core::EphemeralBits(params), combTeeth);
+        auto A = bn::New();
+        table->exp(A.get(), a, bn::ThreadContext());
+        
+        return A;
+    }
+    
+    bn::BignumPtr Native_A(const SRPParams& params, const BIGNUM* a, bn::MontKernelPath path) {
+        const SRPGroup& group = SRPGroup::Get(params);
+        auto A = bn::New();
+        core::Calculate_A(group, a, A.get(), bn::ThreadContext(), group.montKernel(path).get());
+        
+        return A;
+    }
+    
+    /// g^e as the product of chunked exponentiations run on `pool`. `extra`, if set, is run
+    /// as one more task of the same batch.
+    bn::BignumPtr Parallel_A(const SRPParams& params, const BIGNUM* e, utils::ThreadPool& pool, size_t chunks,
+                             const std::function<void(BN_CTX* ctx)>& extra = nullptr) {
+        const SRPGroup& group = SRPGroup::Get(params);
+        const size_t maxBits = core::EphemeralBits(params);
+        const size_t bits = BN_num_bits(e);
+        if (chunks < 2 || bits > maxBits || bits <= (maxBits + chunks - 1) / chunks) {
+            if (extra) {
+                extra(bn::ThreadContext());
+            }
+            return Calculate_A(params, e);
         }
-        di.update(":");
-        di.update(password);
         
-        auto hash = di.final();
-        auto x = utils::Digest(params.digestType).hash({
-            salt,
-            hash,
+        auto table = group.chunkedBaseTable(maxBits, chunks);
+        std::vector<bn::BignumPtr> pieces(chunks);
+        pool.parallelFor(chunks + (extra ? 1 : 0), [&](size_t i) {
+            if (i == chunks) {
+                extra(bn::ThreadContext());
+            } else {
+                pieces[i] = bn::New();
+                table->exp(pieces[i].get(), i, e, bn::ThreadContext());
+            }
         });
-        return bn::FromBytes(x);
+        
+        BN_CTX* ctx = bn::ThreadContext();
+        auto A = pieces[0];
+        for (size_t i = 1; i < chunks; i++) {
+            bn::ModMul(A.get(), A.get(), pieces[i].get(), group.gn->N, ctx);
+        }
+        
+        return A;
+    }
+    
+    bn::BignumPtr Calculate_k(const SRPParams& params) {
+        return bn::Own(BN_dup(SRPGroup::Get(params).k.get()));
+    }
+    
+    bn::BignumPtr Calculate_x(const SRPParams& params, const std::string& username, const std::string& password, const Buffer& salt) {
+        uint8_t x[SHA512_DIGEST_LENGTH];
+        const SRPGroup& group = SRPGroup::Get(params);
+        core::Calculate_x(group, username.data(), username.size(), password.data(), password.size(), salt.data(), salt.size(), x);
+        return bn::FromBytes(x, DigestSize(params.digestType));
     }
     
     bn::BignumPtr Calculate_u(const SRPParams& params, const BIGNUM* A, const BIGNUM* B) {
-        const size_t bnSize = MinBignumSize(params, SRPFlagSkipZeroes_k_U_X);
-        auto result = utils::Digest(params.digestType).hash({
-            bn::ToBytes(A, bnSize),
-            bn::ToBytes(B, bnSize),
-        });
-        return bn::FromBytes(result);
+        uint8_t u[SHA512_DIGEST_LENGTH];
+        const SRPGroup& group = SRPGroup::Get(params);
+        Buffer scratch(group.bignumSize);
+        core::Calculate_u(group, A, B, scratch.data(), u);
+        return bn::FromBytes(u, DigestSize(params.digestType));
+    }
+    
+    bn::BignumPtr Hash_K(const SRPGroup& group, const BIGNUM* S) {
+        uint8_t K[SHA512_DIGEST_LENGTH];
+        Buffer scratch(group.bignumSize);
+        core::Calculate_K(group, S, scratch.data(), K);
+        return bn::FromBytes(K, DigestSize(group.digestType));
     }
     
     bn::BignumPtr CalculateClient_K(const SRPParams& params, const BIGNUM* u, const BIGNUM* x, const BIGNUM* k, const BIGNUM* a, const BIGNUM* B) {
-        auto v = bn::New();
-        auto K = bn::New();
-        auto tmp1 = bn::New();
-        auto tmp2 = bn::New();
-        auto tmp3 = bn::New();
-        
-        auto ctx = bn::MakeContext();
-        BN_mod_exp(v.get(), params.gn->g, x, params.gn->N, ctx.get());
-        
-        // S = (B - k*(g^x)) ^ (a + ux)
-        BN_mul(tmp1.get(), u, x, ctx.get());
-        BN_add(tmp2.get(), a, tmp1.get());                       // tmp2 = (a + ux)
-        BN_mod_exp(tmp1.get(), params.gn->g, x, params.gn->N, ctx.get());
-        BN_mul(tmp3.get(), k, tmp1.get(), ctx.get());            // tmp3 = k*(g^x)
-        BN_sub(tmp1.get(), B, tmp3.get());                       // tmp1 = (B - K*(g^x))
-        BN_mod_exp(K.get(), tmp1.get(), tmp2.get(), params.gn->N, ctx.get());
-        
-        auto result = utils::Digest(params.digestType).hash({ bn::ToBytes(K.get()) });
-        return bn::FromBytes(result);
+        const SRPGroup& group = SRPGroup::Get(params);
+        auto S = bn::New();
+        core::ClientPremaster(group, u, x, k, a, B, S.get(), bn::ThreadContext());
+        return Hash_K(group, S.get());
     }
     
     bn::BignumPtr CalculateServer_K(const SRPParams& params, const BIGNUM* u, const BIGNUM* v, const BIGNUM* b, const BIGNUM* A) {
-        auto tmp1 = bn::New();
-        auto tmp2 = bn::New();
-        auto K = bn::New();
-        auto ctx = bn::MakeContext();
-        
-        // S = (A *(v^u)) ^ b
-        BN_mod(tmp1.get(), A, params.gn->N, ctx.get());
-        BN_mod_exp(tmp1.get(), v, u, params.gn->N, ctx.get());
-        BN_mul(tmp2.get(), A, tmp1.get(), ctx.get());
-        BN_mod_exp(K.get(), tmp2.get(), b, params.gn->N, ctx.get());
-        
-        auto result = utils::Digest(params.digestType).hash({ bn::ToBytes(K.get()) });
-        return bn::FromBytes(result);
+        const SRPGroup& group = SRPGroup::Get(params);
+        auto S = bn::New();
+        core::ServerPremaster(group, u, v, b, A, S.get(), bn::ThreadContext());
+        return Hash_K(group, S.get());
     }
     
     bn::BignumPtr Calculate_M1(const SRPParams& params, const std::string& username, const Buffer& salt, const BIGNUM* A, const BIGNUM* B, const BIGNUM* K) {
-        const size_t bnSize = MinBignumSize(params, SRPFlagSkipZeroes_M1_M2);
-        auto gBytes = bn::ToBytes(params.gn->g, bnSize);
-        auto nBytes = bn::ToBytes(params.gn->N, bnSize);
-        
-        const utils::Digest di(params.digestType);
-        const auto hashG = di.hash({ gBytes });
-        const auto hashN = di.hash({ nBytes });
-        
-        const size_t hashSize = di.hashSize();
-        Buffer hashXor(hashSize);
-        for (size_t i = 0; i < hashSize; i++)
-        {
-            hashXor[i] = hashN[i] ^ hashG[i];
-        }
+        uint8_t M1[SHA512_DIGEST_LENGTH];
+        const SRPGroup& group = SRPGroup::Get(params);
+        Buffer scratch(group.bignumSize);
+        const Buffer KBytes = bn::ToBytes(K);
         
-        const Buffer& hashI = di.hash(username);
-        
-        utils::Digest di_M1(params.digestType);
-        di_M1.update(hashXor);
-        di_M1.update(hashI);
-        di_M1.update(salt);
-        di_M1.update(bn::ToBytes(A, bnSize));
-        di_M1.update(bn::ToBytes(B, bnSize));
-        di_M1.update(bn::ToBytes(K));
-        
-        auto M1 = di_M1.final();
-        return bn::FromBytes(M1);
+        utils::Digest di = core::BeginM1(group, username.data(), username.size(), salt.data(), salt.size());
+        core::FinishM1(group, di, A, B, KBytes.data(), KBytes.size(), scratch.data(), M1);
+        return bn::FromBytes(M1, DigestSize(params.digestType));
     }
     
     bn::BignumPtr Calculate_M2(const SRPParams& params, const BIGNUM* A, const BIGNUM* M, const BIGNUM* K) {
-        const size_t bnSize = MinBignumSize(params, SRPFlagSkipZeroes_M1_M2);
-        utils::Digest di_M2(params.digestType);
-        di_M2.update(bn::ToBytes(A, bnSize));
-        di_M2.update(bn::ToBytes(M));
-        di_M2.update(bn::ToBytes(K));
+        uint8_t M2[SHA512_DIGEST_LENGTH];
+        const SRPGroup& group = SRPGroup::Get(params);
+        Buffer scratch(group.bignumSize);
+        const Buffer MBytes = bn::ToBytes(M);
+        const Buffer KBytes = bn::ToBytes(K);
         
-        auto M2 = di_M2.final();
-        return bn::FromBytes(M2);
+        core::Calculate_M2(group, A, MBytes.data(), MBytes.size(), KBytes.data(), KBytes.size(), scratch.data(), M2);
+        return bn::FromBytes(M2, DigestSize(params.digestType));
     }
     
     bool ClientSafetyCheck(const SRPParams& params, const BIGNUM* B, const BIGNUM* u) {
-        return !BN_is_zero(B) && !BN_is_zero(u);
+        return core::ClientSafetyCheck(B, u);
     }
     
     bool ServerSafetyCheck(const SRPParams& params, const BIGNUM* A) {
-        auto ctx = bn::MakeContext();
-        auto tmp = bn::New();
-        BN_mod(tmp.get(), A, params.gn->N, ctx.get());
-        
-        return !BN_is_zero(tmp.get());
+        return core::ServerSafetyCheck(SRPGroup::Get(params), A, bn::ThreadContext());
     }
     
     SRP_gN* gN(SRPBits bits) {
@@ -220,6 +202,23 @@ namespace {
         return SRP_get_default_gN(it->second);
         SSRP_ENABLE_DEPRECATION_WARNINGS
     }
+    
+    template <class Fn, class R, class... Args>
+    bool IsTarget(const std::function<Fn>& fn, R (*target)(Args...)) {
+        auto ptr = fn.template target<R (*)(Args...)>();
+        return ptr && *ptr == target;
+    }
+    
+    template <class R, class... Args>
+    std::function<R(Args...)> Measured(std::function<R(Args...)> fn,
+                                       std::shared_ptr<SRPMetrics> metrics, SRPMetrics::Routine routine) {
+        return [fn = std::move(fn), metrics = std::move(metrics), routine](Args... args) {
+            const auto start = std::chrono::steady_clock::now();
+            R result = fn(std::forward<Args>(args)...);
+            metrics->record(routine, std::chrono::steady_clock::now() - start);
+            return result;
+        };
+    }
 }
 
 std::function<const SRP_gN*(SRPBits bits)> simplesrp::SRPRoutines::gN = ::gN;
@@ -228,6 +227,8 @@ simplesrp::SRPRoutines::SRPRoutines()
 : randomBN(::RandomBN)
 , calculate_A(::Calculate_A)
 , calculate_B(::Calculate_B)
+, combine_B(::Combine_B)
+, combineKV_B(::CombineKV_B)
 , calculate_k(::Calculate_k)
 , calculate_x(::Calculate_x)
 , calculate_u(::Calculate_u)
@@ -239,6 +240,95 @@ simplesrp::SRPRoutines::SRPRoutines()
 , serverSafetyCheck(::ServerSafetyCheck)
 {}
 
+bool simplesrp::core::IsBuiltIn_x(const SRPRoutines& routines) {
+    return IsTarget(routines.calculate_x, &::Calculate_x);
+}
+
+bool simplesrp::core::IsBuiltInServerVerification(const SRPRoutines& routines) {
+    return IsTarget(routines.serverSafetyCheck, &::ServerSafetyCheck)
+        && IsTarget(routines.calculate_u, &::Calculate_u)
+        && IsTarget(routines.calculateServer_K, &::CalculateServer_K)
+        && IsTarget(routines.calculate_M1, &::Calculate_M1)
+        && IsTarget(routines.calculate_M2, &::Calculate_M2);
+}
+
+void simplesrp::SRPRoutines::useFixedBaseExponentiation(size_t combTeeth) {
+    combTeeth = std::min(std::max<size_t>(combTeeth, 1), bn::FixedBaseTable::MaxTeeth);
+    calculate_A = [combTeeth](const SRPParams& params, const BIGNUM* a) {
+        return FixedBase_A(params, a, combTeeth);
+    };
+    calculate_B = [combTeeth](const SRPParams& params, const BIGNUM* b, const BIGNUM* v, const BIGNUM* k) {
+        auto gb = FixedBase_A(params, b, combTeeth);
+        return Combine_B(params, gb.get(), v, k);
+    };
+}
+
+void simplesrp::SRPRoutines::useNativeExponentiation(bn::MontKernelPath path) {
+    calculate_A = [path](const SRPParams& params, const BIGNUM* a) {
+        return Native_A(params, a, path);
+    };
+    calculate_B = [path](const SRPParams& params, const BIGNUM* b, const BIGNUM* v, const BIGNUM* k) {
+        auto gb = Native_A(params, b, path);
+        return Combine_B(params, gb.get(), v, k);
+    };
+    calculateClient_K = [path](const SRPParams& params, const BIGNUM* u, const BIGNUM* x, const BIGNUM* k, const BIGNUM* a, const BIGNUM* B) {
+        const SRPGroup& group = SRPGroup::Get(params);
+        auto S = bn::New();
+        core::ClientPremaster(group, u, x, k, a, B, S.get(), bn::ThreadContext(), group.montKernel(path).get());
+        return Hash_K(group, S.get());
+    };
+    calculateServer_K = [path](const SRPParams& params, const BIGNUM* u, const BIGNUM* v, const BIGNUM* b, const BIGNUM* A) {
+        const SRPGroup& group = SRPGroup::Get(params);
+        auto S = bn::New();
+        core::ServerPremaster(group, u, v, b, A, S.get(), bn::ThreadContext(), group.montKernel(path).get());
+        return Hash_K(group, S.get());
+    };
+}
+
+void simplesrp::SRPRoutines::useParallelExponentiation(std::shared_ptr<utils::ThreadPool> pool, size_t chunks) {
+    if (!pool) {
+        return;
+    }
+    if (!chunks) {
+        chunks = pool->threadCount();
+    }
+    
+    calculate_A = [pool, chunks](const SRPParams& params, const BIGNUM* a) {
+        return Parallel_A(params, a, *pool, chunks);
+    };
+    calculate_B = [pool, chunks](const SRPParams& params, const BIGNUM* b, const BIGNUM* v, const BIGNUM* k) {
+        const SRPGroup& group = SRPGroup::Get(params);
+        auto kv = bn::New();
+        auto gb = Parallel_A(params, b, *pool, chunks, [&](BN_CTX* ctx) {
+            core::Calculate_kv(group, k, v, kv.get(), ctx);
+        });
+        
+        auto B = bn::New();
+        core::CombineKV_B(group, gb.get(), kv.get(), B.get(), bn::ThreadContext());
+        return B;
+    };
+}
+
+void simplesrp::SRPRoutines::useMetrics(std::shared_ptr<SRPMetrics> metrics) {
+    if (!metrics) {
+        return;
+    }
+    
+    randomBN = Measured(std::move(randomBN), metrics, SRPMetrics::RandomBN);
+    calculate_A = Measured(std::move(calculate_A), metrics, SRPMetrics::Calculate_A);
+    calculate_B = Measured(std::move(calculate_B), metrics, SRPMetrics::Calculate_B);
+    combine_B = Measured(std::move(combine_B), metrics, SRPMetrics::Combine_B);
+    combineKV_B = Measured(std::move(combineKV_B), metrics, SRPMetrics::CombineKV_B);
+    calculate_k = Measured(std::move(calculate_k), metrics, SRPMetrics::Calculate_k);
+    calculate_x = Measured(std::move(calculate_x), metrics, SRPMetrics::Calculate_x);
+    calculate_u = Measured(std::move(calculate_u), metrics, SRPMetrics::Calculate_u);
+    calculateClient_K = Measured(std::move(calculateClient_K), metrics, SRPMetrics::CalculateClient_K);
+    calculateServer_K = Measured(std::move(calculateServer_K), metrics, SRPMetrics::CalculateServer_K);
+    calculate_M1 = Measured(std::move(calculate_M1), metrics, SRPMetrics::Calculate_M1);
+    calculate_M2 = Measured(std::move(calculate_M2), metrics, SRPMetrics::Calculate_M2);
+    clientSafetyCheck = Measured(std::move(clientSafetyCheck), metrics, SRPMetrics::ClientSafetyCheck);
+    serverSafetyCheck = Measured(std::move(serverSafetyCheck), metrics, SRPMetrics::ServerSafetyCheck);
+}
 
 utils::Digest::Digest(DigestType digestType)
 : m_digestType(digestType)
@@ -300,29 +390,32 @@ void utils::Digest::update(const Buffer& buffer) {
 
 Buffer utils::Digest::final() {
     Buffer hash(hashSize());
+    final(hash.data());
+    return hash;
+}
+
+void utils::Digest::final(uint8_t* hash) {
     SSRP_DISABLE_DEPRECATION_WARNINGS
     switch (m_digestType) {
     case DigestType::SHA1:
-        SHA1_Final(hash.data(), &m_ctx.sha1);
+        SHA1_Final(hash, &m_ctx.sha1);
         break;
     case DigestType::SHA224:
-        SHA224_Final(hash.data(), &m_ctx.sha256);
+        SHA224_Final(hash, &m_ctx.sha256);
         break;
     case DigestType::SHA256:
-        SHA256_Final(hash.data(), &m_ctx.sha256);
+        SHA256_Final(hash, &m_ctx.sha256);
         break;
     case DigestType::SHA384:
-        SHA384_Final(hash.data(), &m_ctx.sha512);
+        SHA384_Final(hash, &m_ctx.sha512);
         break;
     case DigestType::SHA512:
-        SHA512_Final(hash.data(), &m_ctx.sha512);
+        SHA512_Final(hash, &m_ctx.sha512);
         break;
     default:
         break;
     }
     SSRP_ENABLE_DEPRECATION_WARNINGS
-    
-    return hash;
 }
 
 Buffer utils::Digest::hash(std::initializer_list<Buffer> buffers) const {
@@ -338,12 +431,5 @@ Buffer utils::Digest::hash(const std::string& str) const {
 }
 
 size_t utils::Digest::hashSize() const {
-    switch (m_digestType) {
-    case DigestType::SHA1: return SHA_DIGEST_LENGTH;
-    case DigestType::SHA224: return SHA224_DIGEST_LENGTH;
-    case DigestType::SHA256: return SHA256_DIGEST_LENGTH;
-    case DigestType::SHA384: return SHA384_DIGEST_LENGTH;
-    case DigestType::SHA512: return SHA512_DIGEST_LENGTH;
-    default: return 0;
-    }
+    return DigestSize(m_digestType);
 }
@@ -0,0 +1,94 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#include <simplesrp/seal.h>
+
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+
+#include <memory>
+
+using namespace simplesrp;
+
+namespace {
+    constexpr int NonceSize = 12;
+    constexpr int TagSize = 16;
+    
+    using CipherContextPtr = std::unique_ptr<EVP_CIPHER_CTX, decltype(&EVP_CIPHER_CTX_free)>;
+}
+
+bool utils::Seal(const Buffer& key, const uint8_t* data, size_t size, Buffer& sealed, const std::string& associatedData) {
+    if (key.size() != SealKeySize || size > INT32_MAX - SealOverhead || associatedData.size() > INT32_MAX) {
+        return false;
+    }
+    
+    Buffer result(size + SealOverhead);
+    uint8_t* nonce = result.data();
+    uint8_t* ciphertext = nonce + NonceSize;
+    uint8_t* tag = ciphertext + size;
+    if (RAND_bytes(nonce, NonceSize) != 1) {
+        return false;
+    }
+    
+    CipherContextPtr ctx(EVP_CIPHER_CTX_new(), &EVP_CIPHER_CTX_free);
+    int length = 0;
+    if (!ctx
+        || EVP_EncryptInit_ex(ctx.get(), EVP_aes_256_gcm(), nullptr, key.data(), nonce) != 1
+        || EVP_EncryptUpdate(ctx.get(), nullptr, &length, reinterpret_cast<const uint8_t*>(associatedData.data()),
+                             static_cast<int>(associatedData.size())) != 1
+        || EVP_EncryptUpdate(ctx.get(), ciphertext, &length, data, static_cast<int>(size)) != 1
+        || EVP_EncryptFinal_ex(ctx.get(), ciphertext + length, &length) != 1
+        || EVP_CIPHER_CTX_ctrl(ctx.get(), EVP_CTRL_GCM_GET_TAG, TagSize, tag) != 1) {
+        return false;
+    }
+    
+    sealed = std::move(result);
+    return true;
+}
+
+bool utils::Open(const Buffer& key, const uint8_t* sealed, size_t size, Buffer& data, const std::string& associatedData) {
+    if (key.size() != SealKeySize || size < SealOverhead || size > INT32_MAX || associatedData.size() > INT32_MAX) {
+        return false;
+    }
+    
+    const size_t dataSize = size - SealOverhead;
+    const uint8_t* nonce = sealed;
+    const uint8_t* ciphertext = nonce + NonceSize;
+    const uint8_t* tag = ciphertext + dataSize;
+    
+    Buffer result(dataSize);
+    CipherContextPtr ctx(EVP_CIPHER_CTX_new(), &EVP_CIPHER_CTX_free);
+    int length = 0;
+    if (!ctx
+        || EVP_DecryptInit_ex(ctx.get(), EVP_aes_256_gcm(), nullptr, key.data(), nonce) != 1
+        || EVP_DecryptUpdate(ctx.get(), nullptr, &length, reinterpret_cast<const uint8_t*>(associatedData.data()),
+                             static_cast<int>(associatedData.size())) != 1
+        || EVP_DecryptUpdate(ctx.get(), result.data(), &length, ciphertext, static_cast<int>(dataSize)) != 1
+        || EVP_CIPHER_CTX_ctrl(ctx.get(), EVP_CTRL_GCM_SET_TAG, TagSize, const_cast<uint8_t*>(tag)) != 1
+        || EVP_DecryptFinal_ex(ctx.get(), result.data() + length, &length) != 1) {
+        return false;
+    }
+    
+    data = std::move(result);
+    return true;
+}
@@ -0,0 +1,263 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#include <simplesrp/simplesrp_c.h>
+#include <simplesrp/core.h>
+#include <simplesrp/group.h>
+#include <simplesrp/random.h>
+#include <simplesrp/raw.h>
+
+#include <openssl/crypto.h>
+
+using namespace simplesrp;
+
+struct simplesrp_client {
+    simplesrp_client(SRPBits bits, DigestType digest) : raw(digest, bits) {}
+    SRPRawClient raw;
+};
+
+struct simplesrp_server {
+    simplesrp_server(SRPBits bits, DigestType digest) : raw(digest, bits) {}
+    SRPRawServer raw;
+};
+
+struct simplesrp_generator {
+    simplesrp_generator(SRPBits bits, DigestType digest) : params(CreateParams(digest, bits)) {}
+    SRPParams params;
+    bn::BignumPtr x = bn::New();
+    bn::BignumPtr v = bn::New();
+};
+
+// The C enums are cast straight to the C++ ones.
+static_assert(SIMPLESRP_BITS_1024 == static_cast<int>(SRPBits::Key1024)
+              && SIMPLESRP_BITS_1536 == static_cast<int>(SRPBits::Key1536)
+              && SIMPLESRP_BITS_2048 == static_cast<int>(SRPBits::Key2048)
+              && SIMPLESRP_BITS_3072 == static_cast<int>(SRPBits::Key3072)
+              && SIMPLESRP_BITS_4096 == static_cast<int>(SRPBits::Key4096)
+              && SIMPLESRP_BITS_6144 == static_cast<int>(SRPBits::Key6144)
+              && SIMPLESRP_BITS_8192 == static_cast<int>(SRPBits::Key8192), "SIMPLESRP_BITS_* differ from SRPBits");
+static_assert(SIMPLESRP_DIGEST_SHA1 == static_cast<int>(DigestType::SHA1)
+              && SIMPLESRP_DIGEST_SHA224 == static_cast<int>(DigestType::SHA224)
+              && SIMPLESRP_DIGEST_SHA256 == static_cast<int>(DigestType::SHA256)
+              && SIMPLESRP_DIGEST_SHA384 == static_cast<int>(DigestType::SHA384)
+              && SIMPLESRP_DIGEST_SHA512 == static_cast<int>(DigestType::SHA512), "SIMPLESRP_DIGEST_* differ from DigestType");
+static_assert(static_cast<unsigned>(SIMPLESRP_FLAG_NO_USERNAME_IN_X) == static_cast<unsigned>(SRPFlagNoUsernameInX)
+              && static_cast<unsigned>(SIMPLESRP_FLAG_SKIP_ZEROES_K_U_X) == static_cast<unsigned>(SRPFlagSkipZeroes_k_U_X)
+              && static_cast<unsigned>(SIMPLESRP_FLAG_SKIP_ZEROES_M1_M2) == static_cast<unsigned>(SRPFlagSkipZeroes_M1_M2), "SIMPLESRP_FLAG_* differ from Flags");
+
+// Exceptions must not unwind through C frames: constructors, the SRPGroup registry and
+// bignum allocation may throw, so every entry point catches everything and reports failure.
+
+namespace {
+    constexpr unsigned AllFlags = SIMPLESRP_FLAG_NO_USERNAME_IN_X | SIMPLESRP_FLAG_SKIP_ZEROES_K_U_X | SIMPLESRP_FLAG_SKIP_ZEROES_M1_M2;
+    
+    bool ToOptions(int bits, int digest, unsigned flags, SRPBits& srpBits, DigestType& digestType) {
+        if (bits < SIMPLESRP_BITS_1024 || bits > SIMPLESRP_BITS_8192
+            || digest < SIMPLESRP_DIGEST_SHA1 || digest > SIMPLESRP_DIGEST_SHA512
+            || (flags & ~AllFlags)) {
+            return false;
+        }
+        srpBits = static_cast<SRPBits>(bits);
+        digestType = static_cast<DigestType>(digest);
+        return true;
+    }
+    
+    template <class Handle>
+    Handle* NewHandle(int bits, int digest, unsigned flags, size_t ephemeralBits) {
+        SRPBits srpBits;
+        DigestType digestType;
+        if (!ToOptions(bits, digest, flags, srpBits, digestType)) {
+            return nullptr;
+        }
+        
+        try {
+            Handle* handle = new Handle(srpBits, digestType);
+            handle->raw.params.flags = static_cast<Flags>(flags);
+            handle->raw.params.ephemeralBits = ephemeralBits;
+            return handle;
+        } catch (...) {
+            return nullptr;
+        }
+    }
+}
+
+size_t simplesrp_bignum_size(int bits) {
+    SRPBits srpBits;
+    DigestType digestType;
+    return ToOptions(bits, SIMPLESRP_DIGEST_SHA1, 0, srpBits, digestType) ? BignumSize(srpBits) : 0;
+}
+
+size_t simplesrp_digest_size(int digest) {
+    SRPBits srpBits;
+    DigestType digestType;
+    return ToOptions(SIMPLESRP_BITS_1024, digest, 0, srpBits, digestType) ? DigestSize(digestType) : 0;
+}
+
+int simplesrp_random_bytes(uint8_t* out, size_t size) {
+    try {
+        return (out || !size) && utils::RandomBytes(out, size);
+    } catch (...) {
+        return 0;
+    }
+}
+
+// === Client ===
+
+simplesrp_client* simplesrp_client_new(int bits, int digest, unsigned flags, size_t ephemeral_bits) {
+    return NewHandle<simplesrp_client>(bits, digest, flags, ephemeral_bits);
+}
+
+void simplesrp_client_free(simplesrp_client* client) {
+    delete client;
+}
+
+int simplesrp_client_start(simplesrp_client* client, uint8_t* A, size_t A_size) {
+    try {
+        return client && A && client->raw.startAuthentication(A, A_size);
+    } catch (...) {
+        return 0;
+    }
+}
+
+int simplesrp_client_process_challenge(simplesrp_client* client,
+                                       const char* username, size_t username_size,
+                                       const char* password, size_t password_size,
+                                       const uint8_t* salt, size_t salt_size,
+                                       const uint8_t* B, size_t B_size,
+                                       uint8_t* M1, size_t* M1_size) {
+    try {
+        return client && B && M1 && M1_size
+            && client->raw.processChallenge(username, username_size, password, password_size,
+                                            salt, salt_size, B, B_size, M1, *M1_size);
+    } catch (...) {
+        return 0;
+    }
+}
+
+int simplesrp_client_verify_session(const simplesrp_client* client, const uint8_t* M2, size_t M2_size) {
+    try {
+        return client && M2 && client->raw.verifySession(M2, M2_size);
+    } catch (...) {
+        return 0;
+    }
+}
+
+size_t simplesrp_client_session_key(const simplesrp_client* client, uint8_t* K, size_t K_size) {
+    try {
+        return client && K ? client->raw.sessionKey(K, K_size) : 0;
+    } catch (...) {
+        return 0;
+    }
+}
+
+// === Server ===
+
+simplesrp_server* simplesrp_server_new(int bits, int digest, unsigned flags, size_t ephemeral_bits) {
+    return NewHandle<simplesrp_server>(bits, digest, flags, ephemeral_bits);
+}
+
+void simplesrp_server_free(simplesrp_server* server) {
+    delete server;
+}
+
+int simplesrp_server_start(simplesrp_server* server,
+                           const char* username, size_t username_size,
+                           const uint8_t* salt, size_t salt_size,
+                           const uint8_t* verifier, size_t verifier_size,
+                           uint8_t* B, size_t B_size) {
+    try {
+        return server && verifier && B
+            && server->raw.startAuthentication(username, username_size, salt, salt_size, verifier, verifier_size, B, B_size);
+    } catch (...) {
+        return 0;
+    }
+}
+
+int simplesrp_server_verify_session(simplesrp_server* server,
+                                    const uint8_t* A, size_t A_size,
+                                    const uint8_t* M1, size_t M1_size,
+                                    uint8_t* M2, size_t* M2_size) {
+    try {
+        return server && A && M1 && M2 && M2_size
+            && server->raw.verifySession(A, A_size, M1, M1_size, M2, *M2_size);
+    } catch (...) {
+        return 0;
+    }
+}
+
+size_t simplesrp_server_session_key(const simplesrp_server* server, uint8_t* K, size_t K_size) {
+    try {
+        return server && K ? server->raw.sessionKey(K, K_size) : 0;
+    } catch (...) {
+        return 0;
+    }
+}
+
+// === Generator ===
+
+simplesrp_generator* simplesrp_generator_new(int bits, int digest, unsigned flags) {
+    SRPBits srpBits;
+    DigestType digestType;
+    if (!ToOptions(bits, digest, flags, srpBits, digestType)) {
+        return nullptr;
+    }
+    
+    try {
+        simplesrp_generator* generator = new simplesrp_generator(srpBits, digestType);
+        generator->params.flags = static_cast<Flags>(flags);
+        return generator;
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void simplesrp_generator_free(simplesrp_generator* generator) {
+    delete generator;
+}
+
+int simplesrp_generator_verifier(simplesrp_generator* generator,
+                                 const char* username, size_t username_size,
+                                 const char* password, size_t password_size,
+                                 const uint8_t* salt, size_t salt_size,
+                                 uint8_t* verifier, size_t verifier_size) {
+    if (!generator || !verifier) {
+        return 0;
+    }
+    
+    try {
+        const SRPGroup& group = SRPGroup::Get(generator->params);
+        if (verifier_size < group.bignumSize) {
+            return 0;
+        }
+        
+        uint8_t x[SHA512_DIGEST_LENGTH];
+        core::Calculate_x(group, username, username_size, password, password_size, salt, salt_size, x);
+        const bool ok = BN_bin2bn(x, static_cast<int>(DigestSize(group.digestType)), generator->x.get())
+            && core::Calculate_A(group, generator->x.get(), generator->v.get(), bn::ThreadContext())
+            && BN_bn2binpad(generator->v.get(), verifier, static_cast<int>(group.bignumSize)) >= 0;
+        OPENSSL_cleanse(x, sizeof(x));
+        BN_clear(generator->x.get());
+        return ok;
+    } catch (...) {
+        return 0;
+    }
+}
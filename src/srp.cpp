@@ -21,25 +21,199 @@
 //  SOFTWARE.
 
 #include <simplesrp/simplesrp.h>
+#include <simplesrp/core.h>
+#include <simplesrp/group.h>
+#include <simplesrp/multihash.h>
+#include <simplesrp/random.h>
+#include <simplesrp/seal.h>
+
+#include <openssl/crypto.h>
+#include <openssl/hmac.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 
 using namespace simplesrp;
 
 namespace {
-    SRPParams CreateParams(DigestType digestType, SRPBits srpBits) {
-        static const std::map<SRPBits, const char*> s_srpBits = {
-            { SRPBits::Key1024, "1024" },
-            { SRPBits::Key1536, "1536" },
-            { SRPBits::Key2048, "2048" },
-            { SRPBits::Key3072, "3072" },
-            { SRPBits::Key4096, "4096" },
-            { SRPBits::Key6144, "6144" },
-            { SRPBits::Key8192, "8192" }
-        };
+    constexpr uint8_t SessionVersion = 1;
+    constexpr uint8_t TicketVersion = 1;
+    constexpr size_t ResumptionNonceSize = 32;
+    
+    /// Associated data of sealed blobs: one key may seal both kinds, but neither opens as the other.
+    const std::string SessionLabel = "simplesrp session";
+    const std::string TicketLabel = "simplesrp ticket";
+    
+    void PutU16(Buffer& out, size_t value) {
+        out.push_back(static_cast<uint8_t>(value >> 8));
+        out.push_back(static_cast<uint8_t>(value));
+    }
+    
+    void PutU64(Buffer& out, uint64_t value) {
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            out.push_back(static_cast<uint8_t>(value >> shift));
+        }
+    }
+    
+    void PutBignum(Buffer& out, const BIGNUM* bn, size_t size) {
+        const size_t offset = out.size();
+        out.resize(offset + size);
+        BN_bn2binpad(bn, out.data() + offset, static_cast<int>(size));
+    }
+    
+    class SessionReader {
+    public:
+        SessionReader(const Buffer& data) : m_ptr(data.data()), m_end(data.data() + data.size()) {}
+        
+        bool u8(size_t& value) {
+            if (m_end - m_ptr < 1) {
+                return false;
+            }
+            value = *m_ptr++;
+            return true;
+        }
+        
+        bool u16(size_t& value) {
+            if (m_end - m_ptr < 2) {
+                return false;
+            }
+            value = (static_cast<size_t>(m_ptr[0]) << 8) | m_ptr[1];
+            m_ptr += 2;
+            return true;
+        }
+        
+        bool u64(uint64_t& value) {
+            if (m_end - m_ptr < 8) {
+                return false;
+            }
+            value = 0;
+            for (int i = 0; i < 8; i++) {
+                value = (value << 8) | m_ptr[i];
+            }
+            m_ptr += 8;
+            return true;
+        }
+        
+        const uint8_t* bytes(size_t size) {
+            if (static_cast<size_t>(m_end - m_ptr) < size) {
+                return nullptr;
+            }
+            const uint8_t* result = m_ptr;
+            m_ptr += size;
+            return result;
+        }
+        
+        bool finished() const {
+            return m_ptr == m_end;
+        }
+        
+    private:
+        const uint8_t* m_ptr;
+        const uint8_t* m_end;
+    };
+    
+    const EVP_MD* MessageDigest(DigestType digestType) {
+        switch (digestType) {
+        case DigestType::SHA1:
+            return EVP_sha1();
+        case DigestType::SHA224:
+            return EVP_sha224();
+        case DigestType::SHA256:
+            return EVP_sha256();
+        case DigestType::SHA384:
+            return EVP_sha384();
+        case DigestType::SHA512:
+            return EVP_sha512();
+        default:
+            return nullptr;
+        }
+    }
+    
+    /// HMAC(K, label | nonces | extra) of resumption: proofs M1, M2 and the fresh key.
+    Buffer ResumptionHmac(DigestType digestType, const Buffer& K, const char* label,
+                          const Buffer& nonces, const Buffer& extra = {}) {
+        Buffer message(label, label + strlen(label));
+        message.insert(message.end(), nonces.begin(), nonces.end());
+        message.insert(message.end(), extra.begin(), extra.end());
+        
+        Buffer mac(DigestSize(digestType));
+        unsigned int size = 0;
+        if (!HMAC(MessageDigest(digestType), K.data(), static_cast<int>(K.size()), message.data(), message.size(), mac.data(), &size)) {
+            return {};
+        }
+        return mac;
+    }
+    
+    uint64_t UnixTime() {
+        return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+    
+    /// Batch verifier generation with built-in x = H(s | H(I | ":" | P)), both hashes of all
+    /// records computed together by MultiDigest. Returns false if a salt could not be generated;
+    /// such records are left with empty salt and verifier.
+    bool GenerateChunk(const SRPVerifierGenerator& gen, SRPVerifierGenerator::Record* records, size_t count) {
+        const SRPParams& params = gen.params;
+        const size_t hashSize = DigestSize(params.digestType);
+        const bool withUsername = !(params.flags & SRPFlagNoUsernameInX);
+        const utils::MultiDigest multiDigest(params.digestType);
+        
+        std::vector<Buffer> messages(count);
+        std::vector<const uint8_t*> data(count);
+        std::vector<size_t> sizes(count);
+        Buffer hashes(count * hashSize);
+        std::vector<uint8_t*> outputs(count);
+        std::vector<bool> failed(count);
+        
+        for (size_t i = 0; i < count; i++) {
+            auto& record = records[i];
+            if (record.salt.empty()) {
+                record.salt.resize(record.saltSize);
+                if (!utils::RandomBytes(record.salt.data(), record.saltSize)) {
+                    record.salt.clear();
+                    failed[i] = true;
+                }
+            }
+            
+            Buffer& message = messages[i];
+            if (withUsername) {
+                message.assign(record.username.begin(), record.username.end());
+            }
+            message.push_back(':');
+            message.insert(message.end(), record.password.begin(), record.password.end());
+            data[i] = message.data();
+            sizes[i] = message.size();
+            outputs[i] = hashes.data() + i * hashSize;
+        }
+        multiDigest.hash(count, data.data(), sizes.data(), outputs.data());
+        
+        for (size_t i = 0; i < count; i++) {
+            OPENSSL_cleanse(messages[i].data(), messages[i].size());
+            messages[i].assign(records[i].salt.begin(), records[i].salt.end());
+            messages[i].insert(messages[i].end(), outputs[i], outputs[i] + hashSize);
+            data[i] = messages[i].data();
+            sizes[i] = messages[i].size();
+        }
+        multiDigest.hash(count, data.data(), sizes.data(), outputs.data());
         
-        SRPParams params;
-        params.digestType = digestType;
-        params.gn = SRPRoutines::gN(srpBits);
-        return params;
+        bool ok = true;
+        for (size_t i = 0; i < count; i++) {
+            if (failed[i]) {
+                records[i].verifier.clear();
+                ok = false;
+            } else {
+                auto x = bn::FromBytes(outputs[i], hashSize);
+                records[i].verifier = bn::ToBytes(gen.routines.calculate_A(params, x.get()));
+            }
+            OPENSSL_cleanse(messages[i].data(), messages[i].size());
+        }
+        OPENSSL_cleanse(hashes.data(), hashes.size());
+        return ok;
+    }
+    
+    bn::BignumPtr ReadBignum(SessionReader& reader, size_t size) {
+        const uint8_t* data = reader.bytes(size);
+        return data ? bn::FromBytes(data, size) : nullptr;
     }
 }
 
@@ -57,7 +231,8 @@ void SRPClient::insecure_startAuthentication(const Buffer& a, Buffer& A) {
     if (!a.empty()) {
         m_a = bn::FromBytes(a);
     }
-    if (!m_a || BN_num_bytes(m_a.get()) != BN_num_bytes(params.gn->N)) {
+    const size_t expectedSize = (core::EphemeralBits(params) + 7) / 8;
+    if (!m_a || static_cast<size_t>(BN_num_bytes(m_a.get())) != expectedSize) {
         m_a = routines.randomBN(params);
     }
     m_A = routines.calculate_A(params, m_a.get());
@@ -65,9 +240,20 @@ void SRPClient::insecure_startAuthentication(const Buffer& a, Buffer& A) {
 }
 
 bool SRPClient::processChallenge(const std::string& username, const std::string& password,
-                                 const Buffer& salt, const Buffer& _B,
-                                 Buffer& _M1, Buffer* _M2 /* = nullptr */) {
-    auto B = bn::FromBytes(_B);
+                                 const Buffer& salt, const Buffer& B,
+                                 Buffer& M1, Buffer* M2 /* = nullptr */) {
+    return processChallenge(username, password, salt, bn::FromBytes(B), M1, M2);
+}
+
+bool SRPClient::processChallenge(const std::string& username, const std::string& password,
+                                 const SRPServerChallengeView& challenge, Buffer& M1) {
+    const Buffer salt(challenge.salt.data, challenge.salt.data + challenge.salt.size);
+    return processChallenge(username, password, salt, bn::FromBytes(challenge.B.data, challenge.B.size), M1, nullptr);
+}
+
+bool SRPClient::processChallenge(const std::string& username, const std::string& password,
+                                 const Buffer& salt, bn::BignumCPtr B,
+                                 Buffer& _M1, Buffer* _M2) {
     auto u = routines.calculate_u(params, m_A.get(), B.get());
     if (!routines.clientSafetyCheck(params, B.get(), u.get())) {
         return false;
@@ -89,15 +275,59 @@ bool SRPClient::processChallenge(const std::string& username, const std::string&
 }
 
 bool SRPClient::verifySession(const Buffer& M2) {
+    return verifySession(SRPProofView{ { M2.data(), M2.size() } });
+}
+
+bool SRPClient::verifySession(const SRPProofView& M2) {
     auto clientM2 = routines.calculate_M2(params, m_A.get(), m_M1.get(), m_K.get());
     Buffer clientM2Bytes = bn::ToBytes(clientM2);
-    return clientM2Bytes == M2;
+    return clientM2Bytes.size() == M2.M.size && std::equal(clientM2Bytes.begin(), clientM2Bytes.end(), M2.M.data);
 }
 
 Buffer SRPClient::sessionKey() const {
     return m_K ? bn::ToBytes(m_K) : Buffer();
 }
 
+bool SRPClient::startResumption(const Buffer& K, Buffer& clientNonce) {
+    m_K = bn::FromBytes(K);
+    m_M1.reset();
+    m_nonces.assign(ResumptionNonceSize, 0);
+    if (!utils::RandomBytes(m_nonces.data(), m_nonces.size())) {
+        m_K.reset();
+        m_nonces.clear();
+        return false;
+    }
+    clientNonce = m_nonces;
+    return true;
+}
+
+bool SRPClient::processResumption(const Buffer& serverNonce, Buffer& M1) {
+    if (!m_K || m_nonces.size() != ResumptionNonceSize || serverNonce.size() != ResumptionNonceSize) {
+        return false;
+    }
+    
+    m_nonces.insert(m_nonces.end(), serverNonce.begin(), serverNonce.end());
+    M1 = ResumptionHmac(params.digestType, bn::ToBytes(m_K), "M1", m_nonces);
+    m_M1 = bn::FromBytes(M1);
+    return !M1.empty();
+}
+
+bool SRPClient::verifyResumption(const Buffer& M2) {
+    if (!m_K || !m_M1 || m_nonces.size() != 2 * ResumptionNonceSize) {
+        return false;
+    }
+    
+    const Buffer K = bn::ToBytes(m_K);
+    const Buffer expected = ResumptionHmac(params.digestType, K, "M2", m_nonces, bn::ToBytes(m_M1.get(), DigestSize(params.digestType)));
+    if (expected.empty() || expected.size() != M2.size() || CRYPTO_memcmp(expected.data(), M2.data(), M2.size()) != 0) {
+        return false;
+    }
+    
+    m_K = bn::FromBytes(ResumptionHmac(params.digestType, K, "K", m_nonces));
+    m_nonces.clear();
+    return true;
+}
+
 // === SRPServer ===
 
 SRPServer::SRPServer(DigestType digestType, SRPBits srpBits) 
@@ -105,19 +335,65 @@ SRPServer::SRPServer(DigestType digestType, SRPBits srpBits)
 {}
 
 void SRPServer::startAuthentication(const std::string& username, const Buffer& salt, const Buffer& verifier, Buffer& B) {
-    m_username = username;
-    m_salt = salt;
-    m_v = bn::FromBytes(verifier);
-    m_b = routines.randomBN(params);
+    beginSession(username, salt, verifier);
     
     auto k = routines.calculate_k(params);
-    m_B = routines.calculate_B(params, m_b.get(), m_v.get(), k.get());
+    bn::BignumPtr gb;
+    if (takeEphemeral(gb)) {
+        m_B = routines.combine_B(params, gb.get(), m_v.get(), k.get());
+    } else {
+        m_b = routines.randomBN(params);
+        m_B = routines.calculate_B(params, m_b.get(), m_v.get(), k.get());
+    }
+    B = bn::ToBytes(m_B.get());
+}
+
+void SRPServer::startAuthentication(const std::string& username, const Buffer& salt, const Buffer& verifier,
+                                    const Buffer& kv, Buffer& B) {
+    // kv that is not a residue mod N cannot come from generateKV: compute k*v instead.
+    auto kvBN = bn::FromBytes(kv);
+    if (kv.empty() || bn::Compare(kvBN.get(), params.gn->N) >= 0) {
+        startAuthentication(username, salt, verifier, B);
+        return;
+    }
+    
+    beginSession(username, salt, verifier);
+    
+    bn::BignumPtr gb;
+    if (!takeEphemeral(gb)) {
+        m_b = routines.randomBN(params);
+        gb = routines.calculate_A(params, m_b.get());
+    }
+    m_B = routines.combineKV_B(params, gb.get(), kvBN.get());
     B = bn::ToBytes(m_B.get());
 }
 
-bool SRPServer::verifySession(const Buffer& _A, const Buffer& M1, Buffer& _M2) {
-    auto A = bn::FromBytes(_A);
+void SRPServer::beginSession(const std::string& username, const Buffer& salt, const Buffer& verifier) {
+    m_username = username;
+    m_verified = false;
+    m_salt = salt;
+    m_v = bn::FromBytes(verifier);
+}
+
+bool SRPServer::takeEphemeral(bn::BignumPtr& gb) {
+    return ephemeralPool && ephemeralPool->matches(params) && ephemeralPool->take(m_b, gb);
+}
+
+void SRPServer::startAuthentication(const SRPClientHelloView& hello, const Buffer& salt, const Buffer& verifier, Buffer& B) {
+    startAuthentication(std::string(hello.username, hello.usernameSize), salt, verifier, B);
+}
+
+bool SRPServer::verifySession(const Buffer& A, const Buffer& M1, Buffer& M2) {
+    return verifySession(SRPBytesView{ A.data(), A.size() }, SRPProofView{ { M1.data(), M1.size() } }, M2);
+}
+
+bool SRPServer::verifySession(SRPBytesView _A, const SRPProofView& M1, Buffer& _M2) {
+    m_verified = false;
+    auto A = bn::FromBytes(_A.data, _A.size);
     if (!routines.serverSafetyCheck(params, A.get())) {
+        if (metrics) {
+            metrics->recordFailedSafetyCheck();
+        }
         return false;
     }
     
@@ -126,12 +402,16 @@ bool SRPServer::verifySession(const Buffer& _A, const Buffer& M1, Buffer& _M2) {
     
     auto serverM1 = routines.calculate_M1(params, m_username, m_salt, A.get(), m_B.get(), m_K.get());
     Buffer serverM1Bytes = bn::ToBytes(serverM1.get());
-    if (serverM1Bytes != M1) {
+    if (serverM1Bytes.size() != M1.M.size || !std::equal(serverM1Bytes.begin(), serverM1Bytes.end(), M1.M.data)) {
+        if (metrics) {
+            metrics->recordM1Mismatch();
+        }
         return false;
     }
     
     auto M2 = routines.calculate_M2(params, A.get(), serverM1.get(), m_K.get());
     _M2 = bn::ToBytes(M2.get());
+    m_verified = true;
     return true;
 }
 
@@ -140,6 +420,180 @@ Buffer SRPServer::sessionKey() {
     return m_K ? bn::ToBytes(m_K) : Buffer();
 }
 
+bool SRPServer::exportSession(Buffer& session) const {
+    if (!m_b || !m_B || !m_v || m_username.size() > UINT16_MAX || m_salt.size() > UINT16_MAX) {
+        return false;
+    }
+    
+    const size_t NSize = BN_num_bytes(params.gn->N);
+    const size_t bSize = std::max((core::EphemeralBits(params) + 7) / 8, static_cast<size_t>(BN_num_bytes(m_b.get())));
+    
+    session.clear();
+    session.reserve(7 + bSize + 2 * NSize + 4 + m_salt.size() + m_username.size());
+    session.push_back(SessionVersion);
+    session.push_back(static_cast<uint8_t>(params.digestType));
+    session.push_back(static_cast<uint8_t>(params.flags));
+    PutU16(session, NSize);
+    PutU16(session, bSize);
+    PutBignum(session, m_b.get(), bSize);
+    PutBignum(session, m_B.get(), NSize);
+    PutBignum(session, m_v.get(), NSize);
+    PutU16(session, m_salt.size());
+    session.insert(session.end(), m_salt.begin(), m_salt.end());
+    PutU16(session, m_username.size());
+    session.insert(session.end(), m_username.begin(), m_username.end());
+    return true;
+}
+
+bool SRPServer::exportSession(const Buffer& key, std::chrono::seconds lifetime, Buffer& session) const {
+    Buffer plain;
+    if (lifetime.count() <= 0 || !exportSession(plain)) {
+        return false;
+    }
+    
+    // The expiry follows the plain blob, so the rest is exactly what `importSession` reads.
+    PutU64(plain, UnixTime() + lifetime.count());
+    const bool sealed = utils::Seal(key, plain.data(), plain.size(), session, SessionLabel);
+    OPENSSL_cleanse(plain.data(), plain.size());
+    return sealed;
+}
+
+bool SRPServer::importSession(const Buffer& session) {
+    SessionReader reader(session);
+    size_t version = 0, digestType = 0, flags = 0, NSize = 0, bSize = 0;
+    if (!reader.u8(version) || version != SessionVersion
+        || !reader.u8(digestType) || digestType != static_cast<size_t>(params.digestType)
+        || !reader.u8(flags) || flags != static_cast<size_t>(params.flags)
+        || !reader.u16(NSize) || NSize != static_cast<size_t>(BN_num_bytes(params.gn->N))
+        || !reader.u16(bSize)) {
+        return false;
+    }
+    
+    auto b = ReadBignum(reader, bSize);
+    auto B = ReadBignum(reader, NSize);
+    auto v = ReadBignum(reader, NSize);
+    if (!b || !B || !v || BN_is_zero(b.get())
+        || BN_is_zero(B.get()) || bn::Compare(B.get(), params.gn->N) >= 0
+        || BN_is_zero(v.get()) || bn::Compare(v.get(), params.gn->N) >= 0) {
+        return false;
+    }
+    
+    size_t saltSize = 0, usernameSize = 0;
+    const uint8_t* salt = reader.u16(saltSize) ? reader.bytes(saltSize) : nullptr;
+    const uint8_t* username = salt && reader.u16(usernameSize) ? reader.bytes(usernameSize) : nullptr;
+    if (!username || !reader.finished()) {
+        return false;
+    }
+    
+    m_username.assign(reinterpret_cast<const char*>(username), usernameSize);
+    m_salt.assign(salt, salt + saltSize);
+    m_b = std::move(b);
+    m_B = std::move(B);
+    m_v = std::move(v);
+    m_K.reset();
+    m_verified = false;
+    return true;
+}
+
+bool SRPServer::importSession(const Buffer& key, const Buffer& session) {
+    Buffer plain;
+    if (!utils::Open(key, session.data(), session.size(), plain, SessionLabel)) {
+        return false;
+    }
+    
+    uint64_t expiry = 0;
+    SessionReader reader(plain);
+    const bool fresh = plain.size() >= 8 && reader.bytes(plain.size() - 8) && reader.u64(expiry) && UnixTime() < expiry;
+    plain.resize(fresh ? plain.size() - 8 : 0);
+    const bool imported = fresh && importSession(plain);
+    OPENSSL_cleanse(plain.data(), plain.size());
+    return imported;
+}
+
+bool SRPServer::issueTicket(const Buffer& key, std::chrono::seconds lifetime, Buffer& ticket) const {
+    if (!m_verified || !m_K || m_username.size() > UINT16_MAX || lifetime.count() <= 0) {
+        return false;
+    }
+    
+    const Buffer K = bn::ToBytes(m_K);
+    Buffer plain;
+    plain.reserve(15 + K.size() + m_username.size());
+    plain.push_back(TicketVersion);
+    plain.push_back(static_cast<uint8_t>(params.digestType));
+    plain.push_back(static_cast<uint8_t>(params.flags));
+    PutU16(plain, BN_num_bytes(params.gn->N));
+    PutU64(plain, UnixTime() + lifetime.count());
+    PutU16(plain, K.size());
+    plain.insert(plain.end(), K.begin(), K.end());
+    PutU16(plain, m_username.size());
+    plain.insert(plain.end(), m_username.begin(), m_username.end());
+    
+    const bool sealed = utils::Seal(key, plain.data(), plain.size(), ticket, TicketLabel);
+    OPENSSL_cleanse(plain.data(), plain.size());
+    return sealed;
+}
+
+bool SRPServer::startResumption(const Buffer& key, const Buffer& ticket, const Buffer& clientNonce,
+                                std::string& username, Buffer& serverNonce) {
+    Buffer plain;
+    if (clientNonce.size() != ResumptionNonceSize || !utils::Open(key, ticket.data(), ticket.size(), plain, TicketLabel)) {
+        return false;
+    }
+    
+    SessionReader reader(plain);
+    size_t version = 0, digestType = 0, flags = 0, NSize = 0, KSize = 0, usernameSize = 0;
+    uint64_t expiry = 0;
+    const bool valid = reader.u8(version) && version == TicketVersion
+        && reader.u8(digestType) && digestType == static_cast<size_t>(params.digestType)
+        && reader.u8(flags) && flags == static_cast<size_t>(params.flags)
+        && reader.u16(NSize) && NSize == static_cast<size_t>(BN_num_bytes(params.gn->N))
+        && reader.u64(expiry) && UnixTime() < expiry
+        && reader.u16(KSize) && KSize > 0;
+    const uint8_t* K = valid ? reader.bytes(KSize) : nullptr;
+    const uint8_t* name = K && reader.u16(usernameSize) ? reader.bytes(usernameSize) : nullptr;
+    if (!name || !reader.finished()) {
+        OPENSSL_cleanse(plain.data(), plain.size());
+        return false;
+    }
+    
+    m_username.assign(reinterpret_cast<const char*>(name), usernameSize);
+    m_K = bn::FromBytes(K, KSize);
+    m_verified = false;
+    OPENSSL_cleanse(plain.data(), plain.size());
+    
+    m_nonces = clientNonce;
+    m_nonces.resize(2 * ResumptionNonceSize);
+    if (!utils::RandomBytes(m_nonces.data() + ResumptionNonceSize, ResumptionNonceSize)) {
+        m_K.reset();
+        m_nonces.clear();
+        return false;
+    }
+    serverNonce.assign(m_nonces.begin() + ResumptionNonceSize, m_nonces.end());
+    username = m_username;
+    return true;
+}
+
+bool SRPServer::verifyResumption(const Buffer& M1, Buffer& M2) {
+    if (!m_K || m_verified || m_nonces.size() != 2 * ResumptionNonceSize) {
+        return false;
+    }
+    
+    const Buffer K = bn::ToBytes(m_K);
+    const Buffer expected = ResumptionHmac(params.digestType, K, "M1", m_nonces);
+    if (expected.empty() || expected.size() != M1.size() || CRYPTO_memcmp(expected.data(), M1.data(), M1.size()) != 0) {
+        if (metrics) {
+            metrics->recordM1Mismatch();
+        }
+        return false;
+    }
+    
+    M2 = ResumptionHmac(params.digestType, K, "M2", m_nonces, M1);
+    m_K = bn::FromBytes(ResumptionHmac(params.digestType, K, "K", m_nonces));
+    m_nonces.clear();
+    m_verified = true;
+    return true;
+}
+
 // === SRPVerifierGenerator ===
 
 SRPVerifierGenerator::SRPVerifierGenerator(DigestType digestType, SRPBits srpBits)
@@ -148,8 +602,12 @@ SRPVerifierGenerator::SRPVerifierGenerator(DigestType digestType, SRPBits srpBit
 
 void SRPVerifierGenerator::generate(const std::string& username, const std::string& password,
                                     const size_t saltSize, Buffer& _salt, Buffer& _verifier) {
-    auto salt = bn::Random(saltSize);
-    _salt = bn::ToBytes(salt.get(), saltSize);
+    Buffer salt(saltSize);
+    if (!utils::RandomBytes(salt.data(), saltSize)) {
+        _verifier.clear();
+        return;
+    }
+    _salt = std::move(salt);
     generate(username, password, _salt, _verifier);
 }
 
@@ -159,3 +617,45 @@ void SRPVerifierGenerator::generate(const std::string& username, const std::stri
     auto verifier = routines.calculate_A(params, x.get());
     _verifier = bn::ToBytes(verifier);
 }
+
+void SRPVerifierGenerator::generateKV(const Buffer& verifier, Buffer& _kv) {
+    const SRPGroup& group = SRPGroup::Get(params);
+    auto k = routines.calculate_k(params);
+    auto kv = bn::New();
+    core::Calculate_kv(group, k.get(), bn::FromBytes(verifier).get(), kv.get(), bn::ThreadContext());
+    _kv = bn::ToBytes(kv.get(), group.bignumSize);
+}
+
+bool SRPVerifierGenerator::generate(Record* records, size_t count, utils::ThreadPool& pool) {
+    std::atomic<bool> ok = true;
+    if (!core::IsBuiltIn_x(routines)) {
+        pool.parallelFor(count, [this, records, &ok](size_t i) {
+            Record& record = records[i];
+            if (record.salt.empty()) {
+                generate(record.username, record.password, record.saltSize, record.salt, record.verifier);
+                if (record.salt.empty()) {
+                    ok = false;
+                }
+            } else {
+                generate(record.username, record.password, record.salt, record.verifier);
+            }
+        });
+        return ok;
+    }
+    
+    // Chunks are large enough to fill the lanes of MultiDigest, but not so large that threads idle.
+    const size_t chunkSize = std::clamp<size_t>((count + pool.threadCount() - 1) / pool.threadCount(), 1, 64);
+    const size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+    pool.parallelFor(chunkCount, [&](size_t chunk) {
+        const size_t begin = chunk * chunkSize;
+        if (!GenerateChunk(*this, records + begin, std::min(chunkSize, count - begin))) {
+            ok = false;
+        }
+    });
+    return ok;
+}
+
+bool SRPVerifierGenerator::generate(std::vector<Record>& records, size_t threadCount) {
+    utils::ThreadPool pool(threadCount);
+    return generate(records.data(), records.size(), pool);
+}
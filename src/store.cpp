@@ -0,0 +1,347 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#include <simplesrp/store.h>
+
+#include <openssl/crypto.h>
+
+#include <cstring>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+#include <unordered_set>
+
+#if defined(_WIN32)
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace simplesrp;
+
+namespace {
+    constexpr char Magic[8] = { 'S', 'S', 'R', 'P', 'S', 'T', 'O', 'R' };
+    constexpr uint32_t Version = 1;
+    constexpr size_t HeaderSize = 64;
+    constexpr size_t RecordHeaderSize = 24;
+    
+    uint64_t Load(const uint8_t* ptr, size_t size) {
+        uint64_t value = 0;
+        for (size_t i = size; i-- > 0; ) {
+            value = (value << 8) | ptr[i];
+        }
+        return value;
+    }
+    
+    void Store(uint8_t* ptr, uint64_t value, size_t size) {
+        for (size_t i = 0; i < size; i++) {
+            ptr[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+    }
+    
+    /// FNV-1a.
+    uint64_t HashUsername(const char* username, size_t size) {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ static_cast<uint8_t>(username[i])) * 0x100000001b3ull;
+        }
+        return hash;
+    }
+    
+    size_t BucketCount(size_t recordCount) {
+        size_t count = 1;
+        while (count < recordCount * 2) {
+            count <<= 1;
+        }
+        return count;
+    }
+}
+
+// === SRPVerifierStore ===
+
+SRPVerifierStore::~SRPVerifierStore() {
+    close();
+}
+
+bool SRPVerifierStore::open(const std::string& path) {
+    close();
+    
+#if defined(_WIN32)
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    m_buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st = {};
+    void* data = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size >= static_cast<off_t>(HeaderSize)) {
+        data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    m_data = static_cast<const uint8_t*>(data);
+    m_size = static_cast<size_t>(st.st_size);
+#endif
+    
+    const uint8_t* header = m_data;
+    bool valid = m_size >= HeaderSize
+        && memcmp(header, Magic, sizeof(Magic)) == 0
+        && Load(header + 8, 4) == Version;
+    if (valid) {
+        m_srpBits = static_cast<SRPBits>(header[12]);
+        m_digestType = static_cast<DigestType>(header[13]);
+        m_flags = static_cast<Flags>(header[14]);
+        m_verifierSize = Load(header + 16, 4);
+        m_recordSize = Load(header + 20, 4);
+        m_recordCount = Load(header + 24, 8);
+        m_bucketCount = Load(header + 32, 8);
+        
+        const uint64_t bucketsOffset = Load(header + 40, 8);
+        const uint64_t recordsOffset = Load(header + 48, 8);
+        const uint64_t stringsOffset = Load(header + 56, 8);
+        valid = m_verifierSize == BignumSize(m_srpBits) && m_verifierSize > 0
+            && m_recordSize >= RecordHeaderSize + m_verifierSize
+            && m_bucketCount > 0 && (m_bucketCount & (m_bucketCount - 1)) == 0
+            && m_recordCount < m_bucketCount && m_recordCount < UINT32_MAX
+            && bucketsOffset >= HeaderSize
+            && recordsOffset >= bucketsOffset && (recordsOffset - bucketsOffset) / 4 >= m_bucketCount
+            && stringsOffset >= recordsOffset && (stringsOffset - recordsOffset) / m_recordSize >= m_recordCount
+            && stringsOffset <= m_size;
+        if (valid) {
+            m_buckets = m_data + bucketsOffset;
+            m_records = m_data + recordsOffset;
+            m_strings = m_data + stringsOffset;
+            m_stringsSize = m_size - stringsOffset;
+        }
+    }
+    
+    if (!valid) {
+        close();
+    }
+    return valid;
+}
+
+void SRPVerifierStore::close() {
+#if !defined(_WIN32)
+    if (m_data) {
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+#endif
+    m_buffer = Buffer();
+    m_data = nullptr;
+    m_size = 0;
+    m_recordCount = 0;
+    m_bucketCount = 0;
+    m_buckets = nullptr;
+    m_records = nullptr;
+    m_strings = nullptr;
+    m_stringsSize = 0;
+}
+
+bool SRPVerifierStore::isOpen() const {
+    return m_data != nullptr;
+}
+
+SRPBits SRPVerifierStore::srpBits() const {
+    return m_srpBits;
+}
+
+DigestType SRPVerifierStore::digestType() const {
+    return m_digestType;
+}
+
+Flags SRPVerifierStore::flags() const {
+    return m_flags;
+}
+
+size_t SRPVerifierStore::size() const {
+    return m_recordCount;
+}
+
+bool SRPVerifierStore::find(const std::string& username, SRPVerifierView& view) const {
+    return find(username.data(), username.size(), view);
+}
+
+bool SRPVerifierStore::find(const char* username, size_t usernameSize, SRPVerifierView& view) const {
+    if (!m_data) {
+        return false;
+    }
+    
+    const uint64_t hash = HashUsername(username, usernameSize);
+    const size_t mask = m_bucketCount - 1;
+    for (size_t i = 0, bucket = hash & mask; i < m_bucketCount; i++, bucket = (bucket + 1) & mask) {
+        const uint64_t number = Load(m_buckets + bucket * 4, 4);
+        if (!number) {
+            return false;
+        }
+        if (number > m_recordCount) {
+            continue;
+        }
+        
+        const uint8_t* record = m_records + (number - 1) * m_recordSize;
+        const uint64_t offset = Load(record + 8, 8);
+        const size_t recordUsernameSize = Load(record + 16, 4);
+        const size_t saltSize = Load(record + 20, 4);
+        if (Load(record, 8) != hash || recordUsernameSize != usernameSize
+            || offset > m_stringsSize || m_stringsSize - offset < usernameSize + saltSize
+            || memcmp(m_strings + offset, username, usernameSize) != 0) {
+            continue;
+        }
+        
+        view.username = reinterpret_cast<const char*>(m_strings + offset);
+        view.usernameSize = usernameSize;
+        view.salt = m_strings + offset + usernameSize;
+        view.saltSize = saltSize;
+        view.verifier = record + RecordHeaderSize;
+        view.verifierSize = m_verifierSize;
+        return true;
+    }
+    return false;
+}
+
+// === SRPVerifierStoreBuilder ===
+
+SRPVerifierStoreBuilder::SRPVerifierStoreBuilder(DigestType digestType, SRPBits srpBits)
+: generator(digestType, srpBits)
+, m_srpBits(srpBits)
+{}
+
+void SRPVerifierStoreBuilder::add(std::string username, std::string password, size_t saltSize) {
+    SRPVerifierGenerator::Record record;
+    record.username = std::move(username);
+    record.password = std::move(password);
+    record.saltSize = saltSize;
+    m_pending.push_back(std::move(record));
+}
+
+void SRPVerifierStoreBuilder::add(std::string username, Buffer salt, Buffer verifier) {
+    SRPVerifierGenerator::Record record;
+    record.username = std::move(username);
+    record.salt = std::move(salt);
+    record.verifier = std::move(verifier);
+    m_records.push_back(std::move(record));
+}
+
+bool SRPVerifierStoreBuilder::write(const std::string& path, size_t threadCount) {
+    if (!m_pending.empty()) {
+        if (!generator.generate(m_pending, threadCount)) {
+            return false;
+        }
+        for (auto& record : m_pending) {
+            OPENSSL_cleanse(record.password.data(), record.password.size());
+            record.password.clear();
+            m_records.push_back(std::move(record));
+        }
+        m_pending.clear();
+    }
+    
+    const size_t verifierSize = BignumSize(m_srpBits);
+    const size_t recordSize = (RecordHeaderSize + verifierSize + 7) & ~size_t(7);
+    const size_t recordCount = m_records.size();
+    const size_t bucketCount = BucketCount(recordCount);
+    if (recordCount >= UINT32_MAX) {
+        return false;
+    }
+    
+    const size_t bucketsOffset = HeaderSize;
+    const size_t recordsOffset = (bucketsOffset + bucketCount * 4 + 7) & ~size_t(7);
+    const size_t stringsOffset = recordsOffset + recordCount * recordSize;
+    
+    std::unordered_set<std::string_view> usernames;
+    for (const auto& record : m_records) {
+        if (record.username.size() > UINT32_MAX || record.salt.size() > UINT32_MAX
+            || record.verifier.empty() || record.verifier.size() > verifierSize
+            || !usernames.insert(record.username).second) {
+            return false;
+        }
+    }
+    
+    uint8_t header[HeaderSize] = {};
+    memcpy(header, Magic, sizeof(Magic));
+    Store(header + 8, Version, 4);
+    header[12] = static_cast<uint8_t>(m_srpBits);
+    header[13] = static_cast<uint8_t>(generator.params.digestType);
+    header[14] = static_cast<uint8_t>(generator.params.flags);
+    Store(header + 16, verifierSize, 4);
+    Store(header + 20, recordSize, 4);
+    Store(header + 24, recordCount, 8);
+    Store(header + 32, bucketCount, 8);
+    Store(header + 40, bucketsOffset, 8);
+    Store(header + 48, recordsOffset, 8);
+    Store(header + 56, stringsOffset, 8);
+    
+    Buffer buckets(recordsOffset - bucketsOffset);
+    for (size_t i = 0; i < recordCount; i++) {
+        const auto& username = m_records[i].username;
+        size_t bucket = HashUsername(username.data(), username.size()) & (bucketCount - 1);
+        while (Load(buckets.data() + bucket * 4, 4)) {
+            bucket = (bucket + 1) & (bucketCount - 1);
+        }
+        Store(buckets.data() + bucket * 4, i + 1, 4);
+    }
+    
+    // Servers may still have the previous store mapped: it is replaced only by a complete file.
+    const std::string tempPath = path + ".tmp";
+    std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(header), HeaderSize);
+    file.write(reinterpret_cast<const char*>(buckets.data()), static_cast<std::streamsize>(buckets.size()));
+    
+    Buffer slot(recordSize);
+    size_t stringOffset = 0;
+    for (const auto& record : m_records) {
+        std::fill(slot.begin(), slot.end(), 0);
+        Store(slot.data(), HashUsername(record.username.data(), record.username.size()), 8);
+        Store(slot.data() + 8, stringOffset, 8);
+        Store(slot.data() + 16, record.username.size(), 4);
+        Store(slot.data() + 20, record.salt.size(), 4);
+        memcpy(slot.data() + RecordHeaderSize + verifierSize - record.verifier.size(), record.verifier.data(), record.verifier.size());
+        file.write(reinterpret_cast<const char*>(slot.data()), static_cast<std::streamsize>(slot.size()));
+        stringOffset += record.username.size() + record.salt.size();
+    }
+    
+    for (const auto& record : m_records) {
+        file.write(record.username.data(), static_cast<std::streamsize>(record.username.size()));
+        file.write(reinterpret_cast<const char*>(record.salt.data()), static_cast<std::streamsize>(record.salt.size()));
+    }
+    file.close();
+    
+    std::error_code error;
+    if (!file || (std::filesystem::rename(tempPath, path, error), error)) {
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
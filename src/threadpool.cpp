@@ -0,0 +1,125 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#include <simplesrp/threadpool.h>
+
+#include <algorithm>
+#include <atomic>
+
+using namespace simplesrp;
+
+utils::ThreadPool::ThreadPool(size_t threadCount, size_t queueCapacity)
+: m_capacity(queueCapacity)
+{
+    if (!threadCount) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (size_t i = 0; i < threadCount; i++) {
+        m_threads.emplace_back(&ThreadPool::worker, this);
+    }
+}
+
+utils::ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+size_t utils::ThreadPool::threadCount() const {
+    return m_threads.size();
+}
+
+size_t utils::ThreadPool::queueSize() const {
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_tasks.size();
+}
+
+void utils::ThreadPool::submit(std::function<void()> task) {
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        m_spaceCv.wait(lock, [this] { return !m_capacity || m_tasks.size() < m_capacity; });
+        m_tasks.push_back(std::move(task));
+    }
+    m_cv.notify_one();
+}
+
+bool utils::ThreadPool::trySubmit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        if (m_capacity && m_tasks.size() >= m_capacity) {
+            return false;
+        }
+        m_tasks.push_back(std::move(task));
+    }
+    m_cv.notify_one();
+    return true;
+}
+
+void utils::ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& fn) {
+    if (!count) {
+        return;
+    }
+    
+    std::atomic<size_t> next(0);
+    size_t running = std::min(count, m_threads.size());
+    std::mutex doneLock;
+    std::condition_variable doneCv;
+    
+    const size_t workers = running;
+    for (size_t i = 0; i < workers; i++) {
+        submit([&] {
+            for (size_t idx = next++; idx < count; idx = next++) {
+                fn(idx);
+            }
+            std::lock_guard<std::mutex> lock(doneLock);
+            if (--running == 0) {
+                doneCv.notify_one();
+            }
+        });
+    }
+    
+    std::unique_lock<std::mutex> lock(doneLock);
+    doneCv.wait(lock, [&] { return running == 0; });
+}
+
+void utils::ThreadPool::worker() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_cv.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+            if (m_tasks.empty()) {
+                return;
+            }
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+        m_spaceCv.notify_one();
+        task();
+    }
+}
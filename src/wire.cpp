@@ -0,0 +1,184 @@
+//  MIT License
+//
+//  Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in all
+//  copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#include <simplesrp/wire.h>
+
+#include <cstring>
+
+using namespace simplesrp;
+
+namespace {
+    /// Writes `size` bytes of `data` right-aligned into `width` bytes, zeroes before them.
+    uint8_t* PutPadded(uint8_t* out, const uint8_t* data, size_t size, size_t width) {
+        memset(out, 0, width - size);
+        if (size) {
+            memcpy(out + width - size, data, size);
+        }
+        return out + width;
+    }
+    
+    /// View of `data` without leading zero bytes.
+    SRPBytesView Stripped(const uint8_t* data, size_t size) {
+        while (size && !*data) {
+            data++;
+            size--;
+        }
+        return { data, size };
+    }
+}
+
+SRPWireCodec::SRPWireCodec(DigestType digestType, SRPBits srpBits)
+: m_digestType(digestType)
+, m_srpBits(srpBits)
+, m_bignumSize(BignumSize(srpBits))
+, m_digestSize(DigestSize(digestType))
+{}
+
+size_t SRPWireCodec::clientHelloSize(size_t usernameSize) const {
+    return HeaderSize + 2 + usernameSize + m_bignumSize;
+}
+
+size_t SRPWireCodec::serverChallengeSize(size_t saltSize) const {
+    return HeaderSize + 1 + saltSize + m_bignumSize;
+}
+
+size_t SRPWireCodec::proofSize() const {
+    return HeaderSize + m_digestSize;
+}
+
+uint8_t* SRPWireCodec::writeHeader(MessageType type, uint8_t* out) const {
+    out[0] = Version;
+    out[1] = type;
+    out[2] = static_cast<uint8_t>(m_srpBits);
+    out[3] = static_cast<uint8_t>(m_digestType);
+    return out + HeaderSize;
+}
+
+uint8_t SRPWireCodec::messageType(const uint8_t* data, size_t size) const {
+    if (size < HeaderSize || data[0] != Version
+        || data[2] != static_cast<uint8_t>(m_srpBits) || data[3] != static_cast<uint8_t>(m_digestType)
+        || data[1] < ClientHello || data[1] > ServerProof) {
+        return 0;
+    }
+    return data[1];
+}
+
+size_t SRPWireCodec::encodeClientHello(const char* username, size_t usernameSize, const uint8_t* A, size_t ASize,
+                                       uint8_t* out, size_t outSize) const {
+    const size_t size = clientHelloSize(usernameSize);
+    if (usernameSize > UINT16_MAX || ASize > m_bignumSize || outSize < size) {
+        return 0;
+    }
+    
+    uint8_t* ptr = writeHeader(ClientHello, out);
+    *ptr++ = static_cast<uint8_t>(usernameSize >> 8);
+    *ptr++ = static_cast<uint8_t>(usernameSize);
+    if (usernameSize) {
+        memcpy(ptr, username, usernameSize);
+    }
+    PutPadded(ptr + usernameSize, A, ASize, m_bignumSize);
+    return size;
+}
+
+size_t SRPWireCodec::encodeServerChallenge(const uint8_t* salt, size_t saltSize, const uint8_t* B, size_t BSize,
+                                           uint8_t* out, size_t outSize) const {
+    const size_t size = serverChallengeSize(saltSize);
+    if (saltSize > UINT8_MAX || BSize > m_bignumSize || outSize < size) {
+        return 0;
+    }
+    
+    uint8_t* ptr = writeHeader(ServerChallenge, out);
+    *ptr++ = static_cast<uint8_t>(saltSize);
+    if (saltSize) {
+        memcpy(ptr, salt, saltSize);
+    }
+    PutPadded(ptr + saltSize, B, BSize, m_bignumSize);
+    return size;
+}
+
+size_t SRPWireCodec::encodeClientProof(const uint8_t* M1, size_t M1Size, uint8_t* out, size_t outSize) const {
+    return encodeProof(ClientProof, M1, M1Size, out, outSize);
+}
+
+size_t SRPWireCodec::encodeServerProof(const uint8_t* M2, size_t M2Size, uint8_t* out, size_t outSize) const {
+    return encodeProof(ServerProof, M2, M2Size, out, outSize);
+}
+
+size_t SRPWireCodec::encodeProof(MessageType type, const uint8_t* M, size_t MSize, uint8_t* out, size_t outSize) const {
+    const size_t size = proofSize();
+    if (MSize > m_digestSize || outSize < size) {
+        return 0;
+    }
+    
+    PutPadded(writeHeader(type, out), M, MSize, m_digestSize);
+    return size;
+}
+
+bool SRPWireCodec::decodeClientHello(const uint8_t* data, size_t size, SRPClientHelloView& hello) const {
+    if (messageType(data, size) != ClientHello || size < clientHelloSize(0)) {
+        return false;
+    }
+    
+    const uint8_t* ptr = data + HeaderSize;
+    const size_t usernameSize = (static_cast<size_t>(ptr[0]) << 8) | ptr[1];
+    if (size != clientHelloSize(usernameSize)) {
+        return false;
+    }
+    
+    hello.username = reinterpret_cast<const char*>(ptr + 2);
+    hello.usernameSize = usernameSize;
+    hello.A = { ptr + 2 + usernameSize, m_bignumSize };
+    return true;
+}
+
+bool SRPWireCodec::decodeServerChallenge(const uint8_t* data, size_t size, SRPServerChallengeView& challenge) const {
+    if (messageType(data, size) != ServerChallenge || size < serverChallengeSize(0)) {
+        return false;
+    }
+    
+    const uint8_t* ptr = data + HeaderSize;
+    const size_t saltSize = ptr[0];
+    if (size != serverChallengeSize(saltSize)) {
+        return false;
+    }
+    
+    challenge.salt = { ptr + 1, saltSize };
+    challenge.B = { ptr + 1 + saltSize, m_bignumSize };
+    return true;
+}
+
+bool SRPWireCodec::decodeClientProof(const uint8_t* data, size_t size, SRPProofView& proof) const {
+    return decodeProof(ClientProof, data, size, proof);
+}
+
+bool SRPWireCodec::decodeServerProof(const uint8_t* data, size_t size, SRPProofView& proof) const {
+    return decodeProof(ServerProof, data, size, proof);
+}
+
+bool SRPWireCodec::decodeProof(MessageType type, const uint8_t* data, size_t size, SRPProofView& proof) const {
+    if (messageType(data, size) != type || size != proofSize()) {
+        return false;
+    }
+    
+    proof.M = Stripped(data + HeaderSize, m_digestSize);
+    return true;
+}
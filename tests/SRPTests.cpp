@@ -23,12 +23,77 @@
  */
 
 #include <simplesrp/simplesrp.h>
+#include <simplesrp/basic.h>
+#include <simplesrp/core.h>
+#include <simplesrp/engine.h>
+#include <simplesrp/group.h>
+#include <simplesrp/multihash.h>
+#include <simplesrp/random.h>
+#include <simplesrp/raw.h>
+#include <simplesrp/seal.h>
+#include <simplesrp/simplesrp_c.h>
+#include <simplesrp/store.h>
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <thread>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 using namespace ::testing;
 using namespace simplesrp;
 
+namespace {
+    /// Heap allocations made through `operator new` and OpenSSL while `g_countAllocations` is set.
+    std::atomic<bool> g_countAllocations = false;
+    std::atomic<size_t> g_allocations = 0;
+    
+    void* CountingMalloc(size_t size, const char*, int) {
+        if (g_countAllocations) {
+            g_allocations++;
+        }
+        return malloc(size);
+    }
+    
+    void* CountingRealloc(void* ptr, size_t size, const char*, int) {
+        if (g_countAllocations) {
+            g_allocations++;
+        }
+        return realloc(ptr, size);
+    }
+    
+    void CountingFree(void* ptr, const char*, int) {
+        free(ptr);
+    }
+    
+    // Must run before the first OpenSSL allocation.
+    const bool g_countingOpenSSL = CRYPTO_set_mem_functions(CountingMalloc, CountingRealloc, CountingFree) == 1;
+}
+
+void* operator new(size_t size) {
+    if (g_countAllocations) {
+        g_allocations++;
+    }
+    if (void* ptr = malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    free(ptr);
+}
+
 class SRPTest: public TestWithParam<std::tuple<SRPBits, DigestType, Flags>> {};
 
 INSTANTIATE_TEST_SUITE_P(
@@ -109,3 +174,1357 @@ TEST_P(SRPTest, SRPAuthentication) {
     ASSERT_TRUE(client.verifySession(M2));
     EXPECT_FALSE(client.sessionKey().empty());
 }
+
+TEST_P(SRPTest, RawInterop) {
+    SRPBits srpBits = std::get<0>(GetParam());
+    DigestType digestType = std::get<1>(GetParam());
+    Flags flags = std::get<2>(GetParam());
+    
+    std::string username = "user@mail.com";
+    std::string password = "password";
+    
+    SRPVerifierGenerator gen(digestType, srpBits);
+    gen.params.flags = flags;
+    Buffer salt;
+    Buffer verifier;
+    gen.generate(username, password, 20, salt, verifier);
+    
+    // Raw client, classic server.
+    {
+        SRPRawClient client(digestType, srpBits);
+        client.params.flags = flags;
+        Buffer A(client.bignumSize());
+        ASSERT_TRUE(client.startAuthentication(A.data(), A.size()));
+        
+        SRPServer server(digestType, srpBits);
+        server.params.flags = flags;
+        Buffer B;
+        server.startAuthentication(username, salt, verifier, B);
+        
+        Buffer M1(client.digestSize());
+        size_t M1Size = M1.size();
+        ASSERT_TRUE(client.processChallenge(username.data(), username.size(), password.data(), password.size(),
+                                            salt.data(), salt.size(), B.data(), B.size(), M1.data(), M1Size));
+        M1.resize(M1Size);
+        
+        Buffer M2;
+        ASSERT_TRUE(server.verifySession(A, M1, M2));
+        ASSERT_TRUE(client.verifySession(M2.data(), M2.size()));
+        
+        Buffer K(client.digestSize());
+        K.resize(client.sessionKey(K.data(), K.size()));
+        EXPECT_EQ(K, server.sessionKey());
+    }
+    
+    // Classic client, raw server.
+    {
+        SRPClient client(digestType, srpBits);
+        client.params.flags = flags;
+        Buffer A;
+        client.startAuthentication(A);
+        
+        SRPRawServer server(digestType, srpBits);
+        server.params.flags = flags;
+        Buffer B(server.bignumSize());
+        ASSERT_TRUE(server.startAuthentication(username.data(), username.size(), salt.data(), salt.size(),
+                                               verifier.data(), verifier.size(), B.data(), B.size()));
+        
+        Buffer M1;
+        ASSERT_TRUE(client.processChallenge(username, password, salt, B, M1));
+        
+        Buffer M2(server.digestSize());
+        size_t M2Size = M2.size();
+        ASSERT_TRUE(server.verifySession(A.data(), A.size(), M1.data(), M1.size(), M2.data(), M2Size));
+        M2.resize(M2Size);
+        ASSERT_TRUE(client.verifySession(M2));
+        
+        Buffer K(server.digestSize());
+        K.resize(server.sessionKey(K.data(), K.size()));
+        EXPECT_EQ(K, client.sessionKey());
+        
+        M1.back() ^= 1;
+        EXPECT_FALSE(server.verifySession(A.data(), A.size(), M1.data(), M1.size(), M2.data(), M2Size));
+    }
+}
+
+TEST(SRPThreading, ConcurrentAuthentication) {
+    const std::string username = "user@mail.com";
+    const std::string password = "password";
+    
+    SRPVerifierGenerator gen(DigestType::SHA256, SRPBits::Key2048);
+    Buffer salt;
+    Buffer verifier;
+    gen.generate(username, password, 16, salt, verifier);
+    
+    std::vector<std::thread> threads;
+    std::vector<int> results(4);
+    for (size_t i = 0; i < results.size(); i++) {
+        threads.emplace_back([&, i] {
+            for (int n = 0; n < 5; n++) {
+                SRPClient client(DigestType::SHA256, SRPBits::Key2048);
+                SRPServer server(DigestType::SHA256, SRPBits::Key2048);
+                Buffer A, B, M1, M2;
+                client.startAuthentication(A);
+                server.startAuthentication(username, salt, verifier, B);
+                results[i] += client.processChallenge(username, password, salt, B, M1)
+                    && server.verifySession(A, M1, M2)
+                    && client.verifySession(M2);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_THAT(results, Each(5));
+}
+
+TEST(SRPServer, SessionExportImport) {
+    const std::string username = "user@mail.com";
+    const std::string password = "password";
+    
+    SRPVerifierGenerator gen(DigestType::SHA256, SRPBits::Key2048);
+    Buffer salt;
+    Buffer verifier;
+    gen.generate(username, password, 16, salt, verifier);
+    
+    const Buffer key(utils::SealKeySize, 0x5a);
+    for (bool sealed : {false, true}) {
+        SRPClient client(DigestType::SHA256, SRPBits::Key2048);
+        Buffer A, B, M1, M2, session;
+        client.startAuthentication(A);
+        {
+            SRPServer server(DigestType::SHA256, SRPBits::Key2048);
+            server.startAuthentication(username, salt, verifier, B);
+            ASSERT_TRUE(sealed ? server.exportSession(key, std::chrono::seconds(60), session) : server.exportSession(session));
+            Buffer unused;
+            EXPECT_FALSE(server.exportSession(key, std::chrono::seconds(0), unused));
+        }
+        ASSERT_TRUE(client.processChallenge(username, password, salt, B, M1));
+        
+        SRPServer otherDigest(DigestType::SHA1, SRPBits::Key2048);
+        EXPECT_FALSE(sealed ? otherDigest.importSession(key, session) : otherDigest.importSession(session));
+        
+        Buffer truncated(session.begin(), session.end() - 1);
+        SRPServer server(DigestType::SHA256, SRPBits::Key2048);
+        EXPECT_FALSE(sealed ? server.importSession(key, truncated) : server.importSession(truncated));
+        if (sealed) {
+            EXPECT_FALSE(server.importSession(Buffer(utils::SealKeySize, 0x11), session));
+            std::string name;
+            Buffer serverNonce;
+            EXPECT_FALSE(server.startResumption(key, session, Buffer(32, 1), name, serverNonce));   // not a ticket
+        }
+        
+        ASSERT_TRUE(sealed ? server.importSession(key, session) : server.importSession(session));
+        ASSERT_TRUE(server.verifySession(A, M1, M2));
+        EXPECT_TRUE(client.verifySession(M2));
+        EXPECT_EQ(server.sessionKey(), client.sessionKey());
+    }
+}
+
+TEST(SRPServer, SealedSessionExpires) {
+    SRPVerifierGenerator gen(DigestType::SHA256, SRPBits::Key1024);
+    Buffer salt, verifier;
+    gen.generate("user", "password", 16, salt, verifier);
+    
+    const Buffer key(utils::SealKeySize, 0x5a);
+    SRPServer server(DigestType::SHA256, SRPBits::Key1024);
+    Buffer B, session;
+    server.startAuthentication("user", salt, verifier, B);
+    ASSERT_TRUE(server.exportSession(key, std::chrono::seconds(1), session));
+    
+    SRPServer other(DigestType::SHA256, SRPBits::Key1024);
+    EXPECT_TRUE(other.importSession(key, session));
+    std::this_thread::sleep_for(std::chrono::seconds(2));
+    EXPECT_FALSE(other.importSession(key, session));
+}
+
+TEST(SRPWireCodec, Handshake) {
+    const std::string username = "user@mail.com";
+    const std::string password = "password";
+    
+    for (SRPBits bits : { SRPBits::Key1024, SRPBits::Key4096 }) {
+        SRPVerifierGenerator gen(DigestType::SHA256, bits);
+        Buffer salt;
+        Buffer verifier;
+        gen.generate(username, password, 16, salt, verifier);
+        
+        const SRPWireCodec codec(DigestType::SHA256, bits);
+        uint8_t wire[2048];
+        
+        // Classic client, raw server, every message through the codec.
+        for (int attempt = 0; attempt < 4; attempt++) {
+            SRPClient client(DigestType::SHA256, bits);
+            SRPRawServer server(DigestType::SHA256, bits);
+            
+            Buffer A;
+            client.startAuthentication(A);
+            size_t size = codec.encodeClientHello(username.data(), username.size(), A.data(), A.size(), wire, sizeof(wire));
+            ASSERT_EQ(size, codec.clientHelloSize(username.size()));
+            SRPClientHelloView hello;
+            ASSERT_TRUE(codec.decodeClientHello(wire, size, hello));
+            EXPECT_EQ(std::string(hello.username, hello.usernameSize), username);
+            EXPECT_EQ(hello.A.data, wire + size - BignumSize(bits));
+            Buffer helloBytes(wire, wire + size);
+            ASSERT_TRUE(codec.decodeClientHello(helloBytes.data(), helloBytes.size(), hello));
+            
+            Buffer B(BignumSize(bits));
+            ASSERT_TRUE(server.startAuthentication(hello, salt.data(), salt.size(), verifier.data(), verifier.size(), B.data(), B.size()));
+            size = codec.encodeServerChallenge(salt.data(), salt.size(), B.data(), B.size(), wire, sizeof(wire));
+            SRPServerChallengeView challenge;
+            ASSERT_TRUE(codec.decodeServerChallenge(wire, size, challenge));
+            
+            Buffer M1;
+            ASSERT_TRUE(client.processChallenge(username, password, challenge, M1));
+            size = codec.encodeClientProof(M1.data(), M1.size(), wire, sizeof(wire));
+            ASSERT_EQ(size, codec.proofSize());
+            SRPProofView proof;
+            ASSERT_TRUE(codec.decodeClientProof(wire, size, proof));
+            EXPECT_EQ(Buffer(proof.M.data, proof.M.data + proof.M.size), M1);
+            
+            Buffer M2(DigestSize(DigestType::SHA256));
+            size_t M2Size = M2.size();
+            ASSERT_TRUE(server.verifySession(hello.A, proof, M2.data(), M2Size));
+            size = codec.encodeServerProof(M2.data(), M2Size, wire, sizeof(wire));
+            ASSERT_TRUE(codec.decodeServerProof(wire, size, proof));
+            ASSERT_TRUE(client.verifySession(proof));
+            
+            Buffer K(DigestSize(DigestType::SHA256));
+            K.resize(server.sessionKey(K.data(), K.size()));
+            EXPECT_EQ(K, client.sessionKey());
+        }
+        
+        // Raw client, classic server.
+        {
+            SRPRawClient client(DigestType::SHA256, bits);
+            SRPServer server(DigestType::SHA256, bits);
+            
+            Buffer A(client.bignumSize());
+            ASSERT_TRUE(client.startAuthentication(A.data(), A.size()));
+            Buffer hello(codec.clientHelloSize(username.size()));
+            ASSERT_EQ(codec.encodeClientHello(username.data(), username.size(), A.data(), A.size(), hello.data(), hello.size()), hello.size());
+            SRPClientHelloView helloView;
+            ASSERT_TRUE(codec.decodeClientHello(hello.data(), hello.size(), helloView));
+            
+            Buffer B;
+            server.startAuthentication(helloView, salt, verifier, B);
+            size_t size = codec.encodeServerChallenge(salt.data(), salt.size(), B.data(), B.size(), wire, sizeof(wire));
+            SRPServerChallengeView challenge;
+            ASSERT_TRUE(codec.decodeServerChallenge(wire, size, challenge));
+            
+            Buffer M1(client.digestSize());
+            size_t M1Size = M1.size();
+            ASSERT_TRUE(client.processChallenge(username.data(), username.size(), password.data(), password.size(),
+                                                challenge, M1.data(), M1Size));
+            size = codec.encodeClientProof(M1.data(), M1Size, wire, sizeof(wire));
+            SRPProofView proof;
+            ASSERT_TRUE(codec.decodeClientProof(wire, size, proof));
+            
+            Buffer M2;
+            ASSERT_TRUE(server.verifySession(helloView.A, proof, M2));
+            size = codec.encodeServerProof(M2.data(), M2.size(), wire, sizeof(wire));
+            ASSERT_TRUE(codec.decodeServerProof(wire, size, proof));
+            EXPECT_TRUE(client.verifySession(proof));
+        }
+    }
+    
+    // Malformed messages and mismatching codecs.
+    const SRPWireCodec codec(DigestType::SHA256, SRPBits::Key2048);
+    const Buffer A(256, 0x11);
+    const Buffer M(32, 0x22);
+    Buffer hello(codec.clientHelloSize(4));
+    ASSERT_EQ(codec.encodeClientHello("user", 4, A.data(), A.size(), hello.data(), hello.size()), hello.size());
+    EXPECT_EQ(codec.messageType(hello.data(), hello.size()), SRPWireCodec::ClientHello);
+    EXPECT_EQ(codec.encodeClientHello("user", 4, A.data(), A.size(), hello.data(), hello.size() - 1), 0);
+    EXPECT_EQ(codec.encodeClientHello("user", 4, A.data(), 257, hello.data(), hello.size()), 0);
+    
+    SRPClientHelloView helloView;
+    SRPServerChallengeView challenge;
+    SRPProofView proof;
+    EXPECT_FALSE(codec.decodeClientHello(hello.data(), hello.size() - 1, helloView));
+    EXPECT_FALSE(codec.decodeServerChallenge(hello.data(), hello.size(), challenge));
+    EXPECT_FALSE(SRPWireCodec(DigestType::SHA1, SRPBits::Key2048).decodeClientHello(hello.data(), hello.size(), helloView));
+    EXPECT_FALSE(SRPWireCodec(DigestType::SHA256, SRPBits::Key3072).decodeClientHello(hello.data(), hello.size(), helloView));
+    hello[0] = SRPWireCodec::Version + 1;
+    EXPECT_FALSE(codec.decodeClientHello(hello.data(), hello.size(), helloView));
+    
+    Buffer proofBytes(codec.proofSize());
+    const uint8_t shortM[] = { 0x01, 0x02 };
+    ASSERT_EQ(codec.encodeServerProof(shortM, sizeof(shortM), proofBytes.data(), proofBytes.size()), proofBytes.size());
+    EXPECT_FALSE(codec.decodeClientProof(proofBytes.data(), proofBytes.size(), proof));
+    ASSERT_TRUE(codec.decodeServerProof(proofBytes.data(), proofBytes.size(), proof));
+    EXPECT_EQ(Buffer(proof.M.data, proof.M.data + proof.M.size), Buffer(shortM, shortM + sizeof(shortM)));
+    EXPECT_EQ(codec.encodeServerProof(M.data(), 33, proofBytes.data(), proofBytes.size()), 0);
+}
+
+#ifdef SIMPLESRP_C_ENABLE
+TEST(SimpleSRPC, Handshake) {
+    const std::string username = "user@mail.com";
+    const std::string password = "password";
+    const int bits = SIMPLESRP_BITS_2048;
+    const int digest = SIMPLESRP_DIGEST_SHA256;
+    const unsigned flags = SIMPLESRP_FLAG_SKIP_ZEROES_M1_M2;
+    
+    EXPECT_EQ(simplesrp_bignum_size(bits), 256);
+    EXPECT_EQ(simplesrp_digest_size(digest), 32);
+    EXPECT_EQ(simplesrp_bignum_size(7), 0);
+    EXPECT_EQ(simplesrp_client_new(bits, 5, 0, 0), nullptr);
+    EXPECT_EQ(simplesrp_server_new(bits, digest, 1 << 3, 0), nullptr);
+    
+    uint8_t salt[16];
+    ASSERT_TRUE(simplesrp_random_bytes(salt, sizeof(salt)));
+    uint8_t verifier[256];
+    simplesrp_generator* generator = simplesrp_generator_new(bits, digest, flags);
+    ASSERT_NE(generator, nullptr);
+    EXPECT_FALSE(simplesrp_generator_verifier(generator, username.data(), username.size(), password.data(), password.size(),
+                                              salt, sizeof(salt), verifier, sizeof(verifier) - 1));
+    ASSERT_TRUE(simplesrp_generator_verifier(generator, username.data(), username.size(), password.data(), password.size(),
+                                             salt, sizeof(salt), verifier, sizeof(verifier)));
+    simplesrp_generator_free(generator);
+    
+    SRPVerifierGenerator gen(DigestType::SHA256, SRPBits::Key2048);
+    gen.params.flags = SRPFlagSkipZeroes_M1_M2;
+    Buffer expected;
+    gen.generate(username, password, Buffer(salt, salt + sizeof(salt)), expected);
+    EXPECT_EQ(bn::ToBytes(bn::FromBytes(verifier, sizeof(verifier)).get()), expected);
+    
+    // C client, C++ server.
+    {
+        simplesrp_client* client = simplesrp_client_new(bits, digest, flags, 0);
+        ASSERT_NE(client, nullptr);
+        uint8_t A[256];
+        ASSERT_TRUE(simplesrp_client_start(client, A, sizeof(A)));
+        
+        SRPServer server(DigestType::SHA256, SRPBits::Key2048);
+        server.params.flags = SRPFlagSkipZeroes_M1_M2;
+        Buffer B;
+        server.startAuthentication(username, Buffer(salt, salt + sizeof(salt)), Buffer(verifier, verifier + sizeof(verifier)), B);
+        
+        uint8_t M1[64];
+        size_t M1Size = sizeof(M1);
+        ASSERT_TRUE(simplesrp_client_process_challenge(client, username.data(), username.size(), password.data(), password.size(),
+                                                       salt, sizeof(salt), B.data(), B.size(), M1, &M1Size));
+        Buffer M2;
+        ASSERT_TRUE(server.verifySession(Buffer(A, A + sizeof(A)), Buffer(M1, M1 + M1Size), M2));
+        ASSERT_TRUE(simplesrp_client_verify_session(client, M2.data(), M2.size()));
+        
+        uint8_t K[64];
+        const size_t KSize = simplesrp_client_session_key(client, K, sizeof(K));
+        EXPECT_EQ(Buffer(K, K + KSize), server.sessionKey());
+        simplesrp_client_free(client);
+    }
+    
+    // C++ client, C server.
+    {
+        SRPClient client(DigestType::SHA256, SRPBits::Key2048);
+        client.params.flags = SRPFlagSkipZeroes_M1_M2;
+        Buffer A;
+        client.startAuthentication(A);
+        
+        simplesrp_server* server = simplesrp_server_new(bits, digest, flags, 256);
+        ASSERT_NE(server, nullptr);
+        uint8_t B[256];
+        EXPECT_FALSE(simplesrp_server_start(server, username.data(), username.size(), salt, sizeof(salt),
+                                            verifier, sizeof(verifier), B, sizeof(B) - 1));
+        ASSERT_TRUE(simplesrp_server_start(server, username.data(), username.size(), salt, sizeof(salt),
+                                           verifier, sizeof(verifier), B, sizeof(B)));
+        
+        Buffer M1;
+        ASSERT_TRUE(client.processChallenge(username, password, Buffer(salt, salt + sizeof(salt)), Buffer(B, B + sizeof(B)), M1));
+        Buffer wrongM1 = M1;
+        wrongM1[0] ^= 1;
+        uint8_t M2[64];
+        size_t M2Size = sizeof(M2);
+        EXPECT_FALSE(simplesrp_server_verify_session(server, A.data(), A.size(), wrongM1.data(), wrongM1.size(), M2, &M2Size));
+        M2Size = sizeof(M2);
+        ASSERT_TRUE(simplesrp_server_verify_session(server, A.data(), A.size(), M1.data(), M1.size(), M2, &M2Size));
+        ASSERT_TRUE(client.verifySession(Buffer(M2, M2 + M2Size)));
+        
+        uint8_t K[64];
+        const size_t KSize = simplesrp_server_session_key(server, K, sizeof(K));
+        EXPECT_EQ(Buffer(K, K + KSize), client.sessionKey());
+        simplesrp_server_free(server);
+    }
+}
+#endif
+
+TEST(SRPServer, ResumptionTicket) {
+    const std::string username = "user@mail.com";
+    const std::string password = "password";
+    
+    SRPVerifierGenerator gen(DigestType::SHA256, SRPBits::Key2048);
+    Buffer salt;
+    Buffer verifier;
+    gen.generate(username, password, 16, salt, verifier);
+    
+    const Buffer key(utils::SealKeySize, 0x5a);
+    Buffer ticket, K;
+    {
+        SRPClient client(DigestType::SHA256, SRPBits::Key2048);
+        SRPServer server(DigestType::SHA256, SRPBits::Key2048);
+        Buffer A, B, M1, M2;
+        client.startAuthentication(A);
+        server.startAuthentication(username, salt, verifier, B);
+        EXPECT_FALSE(server.issueTicket(key, std::chrono::minutes(10), ticket));
+        ASSERT_TRUE(client.processChallenge(username, password, salt, B, M1));
+        ASSERT_TRUE(server.verifySession(A, M1, M2));
+        ASSERT_TRUE(client.verifySession(M2));
+        EXPECT_FALSE(server.issueTicket(key, std::chrono::seconds(0), ticket));
+        ASSERT_TRUE(server.issueTicket(key, std::chrono::minutes(10), ticket));
+        K = client.sessionKey();
+    }
+    
+    for (int round = 0; round < 2; round++) {
+        SRPClient client(DigestType::SHA256, SRPBits::Key2048);
+        SRPServer server(DigestType::SHA256, SRPBits::Key2048);
+        Buffer clientNonce, serverNonce, M1, M2;
+        std::string resumed;
+        ASSERT_TRUE(client.startResumption(K, clientNonce));
+        
+        SRPServer otherDigest(DigestType::SHA1, SRPBits::Key2048);
+        EXPECT_FALSE(otherDigest.startResumption(key, ticket, clientNonce, resumed, serverNonce));
+        EXPECT_FALSE(server.startResumption(Buffer(utils::SealKeySize, 0x11), ticket, clientNonce, resumed, serverNonce));
+        Buffer tampered = ticket;
+        tampered[tampered.size() / 2] ^= 1;
+        EXPECT_FALSE(server.startResumption(key, tampered, clientNonce, resumed, serverNonce));
+        EXPECT_FALSE(server.importSession(key, ticket));   // not a session blob
+        
+        ASSERT_TRUE(server.startResumption(key, ticket, clientNonce, resumed, serverNonce));
+        EXPECT_EQ(resumed, username);
+        ASSERT_TRUE(client.processResumption(serverNonce, M1));
+        
+        Buffer wrongM1 = M1;
+        wrongM1[0] ^= 1;
+        SRPServer copy = server;
+        EXPECT_FALSE(copy.verifyResumption(wrongM1, M2));
+        
+        ASSERT_TRUE(server.verifyResumption(M1, M2));
+        ASSERT_TRUE(client.verifyResumption(M2));
+        EXPECT_EQ(server.sessionKey(), client.sessionKey());
+        EXPECT_NE(client.sessionKey(), K);
+        
+        // Client that does not know K fails.
+        SRPClient thief(DigestType::SHA256, SRPBits::Key2048);
+        SRPServer victim(DigestType::SHA256, SRPBits::Key2048);
+        ASSERT_TRUE(thief.startResumption(Buffer(K.size(), 0x42), clientNonce));
+        ASSERT_TRUE(victim.startResumption(key, ticket, clientNonce, resumed, serverNonce));
+        ASSERT_TRUE(thief.processResumption(serverNonce, M1));
+        EXPECT_FALSE(victim.verifyResumption(M1, M2));
+        EXPECT_FALSE(victim.issueTicket(key, std::chrono::minutes(10), tampered));
+        
+        // Rotate the ticket for the next round.
+        ASSERT_TRUE(server.issueTicket(key, std::chrono::minutes(10), ticket));
+        K = client.sessionKey();
+    }
+}
+
+template <SRPBits Bits, DigestType Type, Flags Options>
+void TestBasicInterop() {
+    using Client = BasicSRPClient<Bits, Type, Options>;
+    using Server = BasicSRPServer<Bits, Type, Options>;
+    
+    const std::string username = "user@mail.com";
+    const std::string password = "password";
+    
+    SRPVerifierGenerator gen(Type, Bits);
+    gen.params.flags = Options;
+    Buffer salt;
+    Buffer verifier;
+    gen.generate(username, password, 20, salt, verifier);
+    
+    // Basic client, classic server.
+    {
+        Client client;
+        typename Client::PublicValue A;
+        ASSERT_TRUE(client.startAuthentication(A));
+        
+        SRPServer server(Type, Bits);
+        server.params.flags = Options;
+        Buffer B;
+        server.startAuthentication(username, salt, verifier, B);
+        
+        typename Client::Hash M1;
+        size_t M1Size = 0;
+        ASSERT_TRUE(client.processChallenge(username.data(), username.size(), password.data(), password.size(),
+                                            salt.data(), salt.size(), B.data(), B.size(), M1, M1Size));
+        
+        Buffer M2;
+        ASSERT_TRUE(server.verifySession(Buffer(A.begin(), A.end()), Buffer(M1.begin(), M1.begin() + M1Size), M2));
+        ASSERT_TRUE(client.verifySession(M2.data(), M2.size()));
+        
+        typename Client::Hash K;
+        EXPECT_EQ(Buffer(K.begin(), K.begin() + client.sessionKey(K)), server.sessionKey());
+    }
+    
+    // Classic client, basic server.
+    {
+        SRPClient client(Type, Bits);
+        client.params.flags = Options;
+        Buffer A;
+        client.startAuthentication(A);
+        
+        Server server;
+        typename Server::PublicValue B;
+        ASSERT_TRUE(server.startAuthentication(username.data(), username.size(), salt.data(), salt.size(),
+                                               verifier.data(), verifier.size(), B));
+        
+        Buffer M1;
+        ASSERT_TRUE(client.processChallenge(username, password, salt, Buffer(B.begin(), B.end()), M1));
+        
+        typename Server::Hash M2;
+        size_t M2Size = 0;
+        ASSERT_TRUE(server.verifySession(A.data(), A.size(), M1.data(), M1.size(), M2, M2Size));
+        ASSERT_TRUE(client.verifySession(Buffer(M2.begin(), M2.begin() + M2Size)));
+        
+        typename Server::Hash K;
+        EXPECT_EQ(Buffer(K.begin(), K.begin() + server.sessionKey(K)), client.sessionKey());
+        
+        M1.back() ^= 1;
+        EXPECT_FALSE(server.verifySession(A.data(), A.size(), M1.data(), M1.size(), M2, M2Size));
+    }
+}
+
+TEST(BasicSRP, Interop) {
+    TestBasicInterop<SRPBits::Key1024, DigestType::SHA1, Flags{}>();
+    TestBasicInterop<SRPBits::Key2048, DigestType::SHA256, Flags{}>();
+    TestBasicInterop<SRPBits::Key2048, DigestType::SHA512, SRPFlagSkipZeroes_M1_M2>();
+    TestBasicInterop<SRPBits::Key4096, DigestType::SHA384, SRPFlagNoUsernameInX>();
+}
+
+TEST(SRPServer, BatchVerification) {
+    const std::string password = "password";
+    const std::vector<DigestType> digests = { DigestType::SHA1, DigestType::SHA256, DigestType::SHA384, DigestType::SHA512 };
+    
+    std::vector<std::unique_ptr<SRPClient>> clients;
+    std::vector<std::unique_ptr<SRPServer>> servers;
+    std::vector<SRPServer::Verification> items(24);
+    for (size_t i = 0; i < items.size(); i++) {
+        const DigestType digestType = digests[i % digests.size()];
+        const std::string username = "user" + std::to_string(i);
+        SRPVerifierGenerator gen(digestType, SRPBits::Key1024);
+        Buffer salt, verifier;
+        gen.generate(username, password, 4 + i, salt, verifier);
+        
+        clients.push_back(std::make_unique<SRPClient>(digestType, SRPBits::Key1024));
+        servers.push_back(std::make_unique<SRPServer>(digestType, SRPBits::Key1024));
+        if (i % 8 == 1) {
+            servers.back()->params.flags = SRPFlagSkipZeroes_M1_M2;
+        }
+        if (i % 8 == 2) {
+            servers.back()->routines.useMetrics(std::make_shared<SRPMetrics>());
+        }
+        clients.back()->params.flags = servers.back()->params.flags;
+        
+        Buffer B, M1;
+        clients.back()->startAuthentication(items[i].A);
+        servers.back()->startAuthentication(username, salt, verifier, B);
+        ASSERT_TRUE(clients.back()->processChallenge(username, password, salt, B, M1));
+        items[i].server = servers.back().get();
+        items[i].M1 = M1;
+    }
+    items[3].M1.back() ^= 1;
+    items[5].A.assign(items[5].A.size(), 0);
+    
+    auto metrics = std::make_shared<SRPMetrics>();
+    servers[3]->metrics = metrics;
+    servers[5]->metrics = metrics;
+    
+    // Server that has not started authentication fails without touching its state.
+    SRPServer unstarted(DigestType::SHA256, SRPBits::Key1024);
+    items.push_back({ &unstarted, items[0].A, items[0].M1 });
+    
+    SRPServer::verifySessions(items.data(), items.size());
+    EXPECT_FALSE(items.back().verified);
+    EXPECT_TRUE(items.back().M2.empty());
+    EXPECT_TRUE(unstarted.sessionKey().empty());
+    items.pop_back();
+    for (size_t i = 0; i < items.size(); i++) {
+        if (i == 3 || i == 5) {
+            EXPECT_FALSE(items[i].verified);
+            EXPECT_TRUE(items[i].M2.empty());
+            continue;
+        }
+        ASSERT_TRUE(items[i].verified) << i;
+        EXPECT_TRUE(clients[i]->verifySession(items[i].M2)) << i;
+        EXPECT_EQ(clients[i]->sessionKey(), servers[i]->sessionKey()) << i;
+    }
+    EXPECT_EQ(metrics->snapshot().M1Mismatches, 1);
+    EXPECT_EQ(metrics->snapshot().failedSafetyChecks, 1);
+}
+
+TEST(SRPMetrics, RoutinesAndFailures) {
+    const std::string username = "user@mail.com";
+    const std::string password = "password";
+    
+    SRPVerifierGenerator gen(DigestType::SHA256, SRPBits::Key1024);
+    Buffer salt;
+    Buffer verifier;
+    gen.generate(username, password, 16, salt, verifier);
+    
+    auto metrics = std::make_shared<SRPMetrics>();
+    SRPClient client(DigestType::SHA256, SRPBits::Key1024);
+    SRPServer server(DigestType::SHA256, SRPBits::Key1024);
+    server.routines.useMetrics(metrics);
+    server.metrics = metrics;
+    
+    Buffer A, B, M1, M2;
+    client.startAuthentication(A);
+    server.startAuthentication(username, salt, verifier, B);
+    ASSERT_TRUE(client.processChallenge(username, password, salt, B, M1));
+    ASSERT_TRUE(server.verifySession(A, M1, M2));
+    
+    M1.back() ^= 1;
+    EXPECT_FALSE(server.verifySession(A, M1, M2));
+    EXPECT_FALSE(server.verifySession(Buffer(A.size(), 0), M1, M2));
+    
+    const SRPMetricsSnapshot snapshot = metrics->snapshot();
+    EXPECT_EQ(snapshot.randomBN.calls, 1);
+    EXPECT_EQ(snapshot.calculate_B.calls, 1);
+    EXPECT_GT(snapshot.calculate_B.nanoseconds, 0);
+    EXPECT_EQ(snapshot.serverSafetyCheck.calls, 3);
+    EXPECT_EQ(snapshot.calculateServer_K.calls, 2);
+    EXPECT_EQ(snapshot.calculate_M1.calls, 2);
+    EXPECT_EQ(snapshot.calculate_M2.calls, 1);
+    EXPECT_EQ(snapshot.calculateClient_K.calls, 0);
+    EXPECT_EQ(snapshot.failedSafetyChecks, 1);
+    EXPECT_EQ(snapshot.M1Mismatches, 1);
+    
+    metrics->reset();
+    EXPECT_EQ(metrics->snapshot().randomBN.calls, 0);
+}
+
+TEST(SRPVerifierStore, BuildAndLookup) {
+    const std::string path = ::testing::TempDir() + "simplesrp_store_test.bin";
+    
+    SRPVerifierStoreBuilder builder(DigestType::SHA256, SRPBits::Key2048);
+    for (int i = 0; i < 100; i++) {
+        builder.add("user" + std::to_string(i), "password" + std::to_string(i), 16);
+    }
+    SRPVerifierGenerator gen(DigestType::SHA256, SRPBits::Key2048);
+    Buffer salt;
+    Buffer verifier;
+    gen.generate("precomputed", "secret", 8, salt, verifier);
+    builder.add("precomputed", salt, verifier);
+    ASSERT_TRUE(builder.write(path, 2));
+    
+    SRPVerifierStore store;
+    ASSERT_TRUE(store.open(path));
+    EXPECT_EQ(store.size(), 101);
+    EXPECT_EQ(store.srpBits(), SRPBits::Key2048);
+    EXPECT_EQ(store.digestType(), DigestType::SHA256);
+    
+    SRPVerifierView view;
+    EXPECT_FALSE(store.find("user100", view));
+    ASSERT_TRUE(store.find("precomputed", view));
+    EXPECT_EQ(Buffer(view.salt, view.salt + view.saltSize), salt);
+    EXPECT_EQ(bn::ToBytes(bn::FromBytes(view.verifier, view.verifierSize)), verifier);
+    
+    for (int i = 0; i < 100; i += 7) {
+        const std::string username = "user" + std::to_string(i);
+        const std::string password = "password" + std::to_string(i);
+        ASSERT_TRUE(store.find(username, view));
+        ASSERT_EQ(std::string(view.username, view.usernameSize), username);
+        EXPECT_EQ(view.saltSize, 16);
+        
+        SRPClient client(DigestType::SHA256, SRPBits::Key2048);
+        Buffer A;
+        client.startAuthentication(A);
+        
+        SRPRawServer server(DigestType::SHA256, SRPBits::Key2048);
+        Buffer B(server.bignumSize());
+        ASSERT_TRUE(server.startAuthentication(view.username, view.usernameSize, view.salt, view.saltSize,
+                                               view.verifier, view.verifierSize, B.data(), B.size()));
+        
+        Buffer M1;
+        ASSERT_TRUE(client.processChallenge(username, password, Buffer(view.salt, view.salt + view.saltSize), B, M1));
+        Buffer M2(server.digestSize());
+        size_t M2Size = M2.size();
+        EXPECT_TRUE(server.verifySession(A.data(), A.size(), M1.data(), M1.size(), M2.data(), M2Size));
+    }
+    store.close();
+    
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(0);
+        file.put('X');
+    }
+    EXPECT_FALSE(store.open(path));
+    EXPECT_FALSE(store.open(path + ".missing"));
+    std::remove(path.c_str());
+    
+    SRPVerifierStoreBuilder duplicates(DigestType::SHA256, SRPBits::Key1024);
+    duplicates.add("user", "a");
+    duplicates.add("user", "b");
+    EXPECT_FALSE(duplicates.write(path));
+    
+    // A failed write keeps the previous store.
+    SRPVerifierStoreBuilder single(DigestType::SHA256, SRPBits::Key1024);
+    single.add("user", "password");
+    ASSERT_TRUE(single.write(path));
+    SRPVerifierStoreBuilder empty(DigestType::SHA256, SRPBits::Key1024);
+    empty.add("user", salt, Buffer());
+    EXPECT_FALSE(empty.write(path));
+    ASSERT_TRUE(store.open(path));
+    EXPECT_TRUE(store.find("user", view));
+    store.close();
+    EXPECT_FALSE(std::ifstream(path + ".tmp").good());
+    std::remove(path.c_str());
+}
+
+TEST(SRPRawServer, NoAllocationsOnReuse) {
+    ASSERT_TRUE(g_countingOpenSSL);
+    const std::string username = "user@mail.com";
+    const std::string password = "password";
+    
+    for (SRPBits bits : { SRPBits::Key2048, SRPBits::Key4096 }) {
+        SRPVerifierGenerator gen(DigestType::SHA256, bits);
+        Buffer salt, verifier;
+        gen.generate(username, password, 16, salt, verifier);
+        
+        SRPRawClient client(DigestType::SHA256, bits);
+        SRPRawServer server(DigestType::SHA256, bits);
+        Buffer A(client.bignumSize()), B(server.bignumSize());
+        Buffer M1(client.digestSize()), M2(server.digestSize()), K(client.digestSize());
+        
+        auto handshake = [&] {
+            size_t M1Size = M1.size();
+            size_t M2Size = M2.size();
+            return client.startAuthentication(A.data(), A.size())
+                && server.startAuthentication(username.data(), username.size(), salt.data(), salt.size(),
+                                              verifier.data(), verifier.size(), B.data(), B.size())
+                && client.processChallenge(username.data(), username.size(), password.data(), password.size(),
+                                           salt.data(), salt.size(), B.data(), B.size(), M1.data(), M1Size)
+                && server.verifySession(A.data(), A.size(), M1.data(), M1Size, M2.data(), M2Size)
+                && client.verifySession(M2.data(), M2Size)
+                && client.sessionKey(K.data(), K.size()) > 0;
+        };
+        
+        // Warm up per-group constants, thread contexts and a freshly seeded DRBG.
+        utils::ReseedRandom();
+        ASSERT_TRUE(handshake());
+        
+        g_allocations = 0;
+        g_countAllocations = true;
+        bool ok = true;
+        for (int i = 0; i < 10; i++) {
+            ok = handshake() && ok;
+        }
+        g_countAllocations = false;
+        EXPECT_TRUE(ok);
+        EXPECT_EQ(g_allocations, 0) << BN_num_bits(server.params.gn->N) << " bits";
+    }
+}
+
+TEST(SRPVerifierGenerator, PrecomputedKV) {
+    const std::string username = "user@mail.com";
+    const std::string password = "password";
+    
+    SRPVerifierGenerator gen(DigestType::SHA256, SRPBits::Key2048);
+    Buffer salt, verifier, kv;
+    gen.generate(username, password, 16, salt, verifier);
+    gen.generateKV(verifier, kv);
+    EXPECT_EQ(kv.size(), 256);
+    
+    {
+        SRPClient client(DigestType::SHA256, SRPBits::Key2048);
+        SRPServer server(DigestType::SHA256, SRPBits::Key2048);
+        Buffer A, B, M1, M2;
+        client.startAuthentication(A);
+        server.startAuthentication(username, salt, verifier, kv, B);
+        ASSERT_TRUE(client.processChallenge(username, password, salt, B, M1));
+        ASSERT_TRUE(server.verifySession(A, M1, M2));
+        EXPECT_TRUE(client.verifySession(M2));
+    }
+    
+    // Routed through routines; empty or out-of-range kv falls back to k*v.
+    for (const Buffer& badKV : { Buffer(), Buffer(257, 0xff) }) {
+        auto metrics = std::make_shared<SRPMetrics>();
+        SRPClient client(DigestType::SHA256, SRPBits::Key2048);
+        SRPServer server(DigestType::SHA256, SRPBits::Key2048);
+        server.routines.useMetrics(metrics);
+        Buffer A, B, M1, M2;
+        client.startAuthentication(A);
+        server.startAuthentication(username, salt, verifier, kv, B);
+        EXPECT_EQ(metrics->snapshot().combineKV_B.calls, 1);
+        server.startAuthentication(username, salt, verifier, badKV, B);
+        EXPECT_EQ(metrics->snapshot().combineKV_B.calls, 1);
+        EXPECT_EQ(metrics->snapshot().calculate_B.calls, 1);
+        ASSERT_TRUE(client.processChallenge(username, password, salt, B, M1));
+        ASSERT_TRUE(server.verifySession(A, M1, M2));
+        EXPECT_TRUE(client.verifySession(M2));
+    }
+    
+    {
+        SRPClient client(DigestType::SHA256, SRPBits::Key2048);
+        SRPRawServer server(DigestType::SHA256, SRPBits::Key2048);
+        Buffer A, B(server.bignumSize()), M1, M2(server.digestSize());
+        client.startAuthentication(A);
+        ASSERT_TRUE(server.startAuthentication(username.data(), username.size(), salt.data(), salt.size(),
+                                               verifier.data(), verifier.size(), kv.data(), kv.size(), B.data(), B.size()));
+        ASSERT_TRUE(client.processChallenge(username, password, salt, B, M1));
+        size_t M2Size = M2.size();
+        ASSERT_TRUE(server.verifySession(A.data(), A.size(), M1.data(), M1.size(), M2.data(), M2Size));
+        M2.resize(M2Size);
+        EXPECT_TRUE(client.verifySession(M2));
+        
+        const Buffer badKV(256, 0xff);
+        EXPECT_FALSE(server.startAuthentication(username.data(), username.size(), salt.data(), salt.size(),
+                                                verifier.data(), verifier.size(), badKV.data(), badKV.size(), B.data(), B.size()));
+    }
+    
+    {
+        SRPClient client(DigestType::SHA256, SRPBits::Key2048);
+        BasicSRPServer<SRPBits::Key2048, DigestType::SHA256> server;
+        decltype(server)::PublicValue B;
+        const Buffer badKV(256, 0xff);
+        EXPECT_FALSE(server.startAuthentication(username.data(), username.size(), salt.data(), salt.size(),
+                                                verifier.data(), verifier.size(), badKV.data(), badKV.size(), B));
+        
+        Buffer A, M1;
+        client.startAuthentication(A);
+        ASSERT_TRUE(server.startAuthentication(username.data(), username.size(), salt.data(), salt.size(),
+                                               verifier.data(), verifier.size(), kv.data(), kv.size(), B));
+        ASSERT_TRUE(client.processChallenge(username, password, salt, Buffer(B.begin(), B.end()), M1));
+        decltype(server)::Hash M2;
+        size_t M2Size = 0;
+        ASSERT_TRUE(server.verifySession(A.data(), A.size(), M1.data(), M1.size(), M2, M2Size));
+        EXPECT_TRUE(client.verifySession(Buffer(M2.begin(), M2.begin() + M2Size)));
+    }
+}
+
+TEST(MultiDigest, MatchesDigest) {
+    std::vector<Buffer> messages;
+    for (size_t size = 0; size < 300; size += 7) {
+        messages.push_back(bn::ToBytes(bn::Random(size + 1), size + 1));
+        messages.back().resize(size);
+    }
+    std::vector<const uint8_t*> data;
+    std::vector<size_t> sizes;
+    for (const auto& message : messages) {
+        data.push_back(message.data());
+        sizes.push_back(message.size());
+    }
+    
+    for (auto digestType : { DigestType::SHA1, DigestType::SHA224, DigestType::SHA256, DigestType::SHA384, DigestType::SHA512 }) {
+        for (auto path : { utils::MultiDigestPath::Scalar, utils::MultiDigestPath::AVX2, utils::MultiDigestPath::AVX512 }) {
+            utils::MultiDigest multiDigest(digestType, path);
+            std::vector<Buffer> hashes(messages.size(), Buffer(DigestSize(digestType)));
+            std::vector<uint8_t*> outputs;
+            for (auto& hash : hashes) {
+                outputs.push_back(hash.data());
+            }
+            multiDigest.hash(messages.size(), data.data(), sizes.data(), outputs.data());
+            
+            for (size_t i = 0; i < messages.size(); i++) {
+                utils::Digest di(digestType);
+                di.update(messages[i]);
+                ASSERT_EQ(hashes[i], di.final()) << "digest " << int(digestType) << ", path " << int(multiDigest.path()) << ", size " << sizes[i];
+            }
+        }
+    }
+}
+
+TEST(SRPServerEngine, AsyncAuthentication) {
+    const std::string username = "user@mail.com";
+    const std::string password = "password";
+    
+    SRPVerifierGenerator gen(DigestType::SHA256, SRPBits::Key2048);
+    Buffer salt;
+    Buffer verifier;
+    gen.generate(username, password, 16, salt, verifier);
+    
+    SRPServerEngine engine(2, 16);
+    auto server = std::make_shared<SRPServer>(DigestType::SHA256, SRPBits::Key2048);
+    SRPClient client(DigestType::SHA256, SRPBits::Key2048);
+    Buffer A, M1;
+    client.startAuthentication(A);
+    
+    std::promise<Buffer> BPromise;
+    ASSERT_TRUE(engine.startAuthentication(server, username, salt, verifier, [&](const Buffer& B) {
+        BPromise.set_value(B);
+    }));
+    ASSERT_TRUE(client.processChallenge(username, password, salt, BPromise.get_future().get(), M1));
+    
+    std::promise<std::pair<bool, Buffer>> M2Promise;
+    ASSERT_TRUE(engine.verifySession(server, A, M1, [&](bool verified, const Buffer& M2) {
+        M2Promise.set_value({verified, M2});
+    }));
+    const auto result = M2Promise.get_future().get();
+    EXPECT_TRUE(result.first);
+    EXPECT_TRUE(client.verifySession(result.second));
+}
+
+TEST(SRPServerEngine, RejectsWhenQueueIsFull) {
+    SRPVerifierGenerator gen(DigestType::SHA256, SRPBits::Key1024);
+    Buffer salt;
+    Buffer verifier;
+    gen.generate("user", "password", 16, salt, verifier);
+    
+    // Zero capacity is raised to one rather than meaning unbounded.
+    for (size_t capacity : { 1, 0 }) {
+        SRPServerEngine engine(1, capacity);
+        auto server = std::make_shared<SRPServer>(DigestType::SHA256, SRPBits::Key1024);
+        
+        std::promise<void> started;
+        std::promise<void> release;
+        auto releaseFuture = release.get_future().share();
+        ASSERT_TRUE(engine.startAuthentication(server, "user", salt, verifier, [&](const Buffer&) {
+            started.set_value();
+            releaseFuture.wait();
+        }));
+        started.get_future().wait();
+        
+        EXPECT_TRUE(engine.startAuthentication(server, "user", salt, verifier, nullptr));
+        EXPECT_EQ(engine.pendingCount(), 1);
+        EXPECT_FALSE(engine.startAuthentication(server, "user", salt, verifier, nullptr));
+        release.set_value();
+    }
+}
+
+TEST(SRPParams, ShortEphemeralExponents) {
+    const std::string username = "user@mail.com";
+    const std::string password = "password";
+    
+    SRPVerifierGenerator gen(DigestType::SHA256, SRPBits::Key4096);
+    Buffer salt;
+    Buffer verifier;
+    gen.generate(username, password, 16, salt, verifier);
+    
+    SRPClient client(DigestType::SHA256, SRPBits::Key4096);
+    client.params.ephemeralBits = 256;
+    Buffer A;
+    client.startAuthentication(A);
+    
+    SRPServer server(DigestType::SHA256, SRPBits::Key4096);
+    server.params.ephemeralBits = 384;
+    server.routines.useFixedBaseExponentiation();
+    Buffer B;
+    server.startAuthentication(username, salt, verifier, B);
+    
+    Buffer M1;
+    ASSERT_TRUE(client.processChallenge(username, password, salt, B, M1));
+    Buffer M2;
+    ASSERT_TRUE(server.verifySession(A, M1, M2));
+    ASSERT_TRUE(client.verifySession(M2));
+    EXPECT_EQ(client.sessionKey(), server.sessionKey());
+}
+
+TEST(SRPParams, EphemeralBitsBounds) {
+    SRPParams params = { SRPRoutines::gN(SRPBits::Key2048), DigestType::SHA256 };
+    EXPECT_EQ(core::EphemeralBits(params), 2048);
+    params.ephemeralBits = 1;
+    EXPECT_EQ(core::EphemeralBits(params), core::MinEphemeralBits);
+    params.ephemeralBits = 300;
+    EXPECT_EQ(core::EphemeralBits(params), 300);
+    params.ephemeralBits = 100000;
+    EXPECT_EQ(core::EphemeralBits(params), 2048);
+    
+    SRPRoutines routines;
+    params.ephemeralBits = 1;
+    auto a = routines.randomBN(params);
+    EXPECT_GT(BN_num_bits(a.get()), 128);
+}
+
+TEST(SRPEphemeralPool, ServerUsesPool) {
+    const std::string username = "user@mail.com";
+    const std::string password = "password";
+    
+    SRPVerifierGenerator gen(DigestType::SHA256, SRPBits::Key2048);
+    Buffer salt;
+    Buffer verifier;
+    gen.generate(username, password, 16, salt, verifier);
+    
+    SRPServer server(DigestType::SHA256, SRPBits::Key2048);
+    auto pool = std::make_shared<SRPEphemeralPool>(server.params, server.routines, 2, 4);
+    pool->prefill();
+    EXPECT_GE(pool->size(), 4);
+    server.ephemeralPool = pool;
+    
+    for (int i = 0; i < 6; i++) {
+        SRPClient client(DigestType::SHA256, SRPBits::Key2048);
+        Buffer A, B, M1, M2;
+        client.startAuthentication(A);
+        server.startAuthentication(username, salt, verifier, B);
+        ASSERT_TRUE(client.processChallenge(username, password, salt, B, M1));
+        ASSERT_TRUE(server.verifySession(A, M1, M2));
+        ASSERT_TRUE(client.verifySession(M2));
+    }
+    
+    server.params.ephemeralBits = 256;
+    EXPECT_FALSE(pool->matches(server.params));
+}
+
+TEST(SRPVerifierGenerator, Batch) {
+    SRPVerifierGenerator gen(DigestType::SHA256, SRPBits::Key2048);
+    
+    std::vector<SRPVerifierGenerator::Record> records(20);
+    for (size_t i = 0; i < records.size(); i++) {
+        records[i].username = "user" + std::to_string(i);
+        records[i].password = "password" + std::to_string(i);
+        records[i].saltSize = 16;
+        if (i % 2) {
+            records[i].salt = bn::ToBytes(bn::Random(8), 8);
+        }
+    }
+    ASSERT_TRUE(gen.generate(records, 3));
+    
+    for (size_t i = 0; i < records.size(); i++) {
+        const auto& record = records[i];
+        EXPECT_EQ(record.salt.size(), i % 2 ? 8 : 16);
+        Buffer verifier;
+        gen.generate(record.username, record.password, record.salt, verifier);
+        EXPECT_EQ(record.verifier, verifier);
+    }
+}
+
+TEST(SRPVerifierGenerator, BatchAllDigests) {
+    for (auto digestType : { DigestType::SHA1, DigestType::SHA224, DigestType::SHA256, DigestType::SHA384, DigestType::SHA512 }) {
+        SRPVerifierGenerator gen(digestType, SRPBits::Key1024);
+        gen.params.flags = digestType == DigestType::SHA512 ? SRPFlagNoUsernameInX : Flags{};
+        ASSERT_TRUE(core::IsBuiltIn_x(gen.routines));
+        
+        std::vector<SRPVerifierGenerator::Record> records(40);
+        for (size_t i = 0; i < records.size(); i++) {
+            records[i].username = "user" + std::to_string(i);
+            records[i].password = std::string(i * 3, 'p');
+            records[i].saltSize = 8 + i;
+        }
+        ASSERT_TRUE(gen.generate(records, 2));
+        
+        for (const auto& record : records) {
+            Buffer verifier;
+            gen.generate(record.username, record.password, record.salt, verifier);
+            EXPECT_EQ(record.verifier, verifier);
+        }
+    }
+    
+    SRPRoutines routines;
+    routines.useMetrics(std::make_shared<SRPMetrics>());
+    EXPECT_FALSE(core::IsBuiltIn_x(routines));
+}
+
+TEST(SRPRoutines, FixedBaseExponentiation) {
+    for (SRPBits bits : { SRPBits::Key1024, SRPBits::Key3072, SRPBits::Key8192 }) {
+        SRPParams params = { SRPRoutines::gN(bits), DigestType::SHA256 };
+        SRPRoutines reference;
+        for (size_t teeth : { 1, 4, 7 }) {
+            SRPRoutines routines;
+            routines.useFixedBaseExponentiation(teeth);
+            for (size_t size : { 1, 20, 64, 200, 1024 }) {
+                auto e = bn::Random(std::min<size_t>(size, BN_num_bytes(params.gn->N)));
+                EXPECT_EQ(bn::ToBytes(routines.calculate_A(params, e.get())), bn::ToBytes(reference.calculate_A(params, e.get())));
+            }
+        }
+    }
+    
+    // Out-of-range teeth are clamped rather than shifting past size_t or allocating 2^teeth numbers.
+    SRPParams params = { SRPRoutines::gN(SRPBits::Key1024), DigestType::SHA256 };
+    SRPRoutines reference;
+    for (size_t teeth : { 0, 30, 64, 1000 }) {
+        SRPRoutines routines;
+        routines.useFixedBaseExponentiation(teeth);
+        auto e = bn::Random(32);
+        EXPECT_EQ(bn::ToBytes(routines.calculate_A(params, e.get())), bn::ToBytes(reference.calculate_A(params, e.get())));
+    }
+    auto e = bn::Random(32);
+    auto r = bn::New();
+    ASSERT_TRUE(SRPGroup::Get(params).fixedBaseTable(256, 64)->exp(r.get(), e.get(), bn::ThreadContext()));
+    EXPECT_EQ(bn::ToBytes(r.get()), bn::ToBytes(reference.calculate_A(params, e.get())));
+}
+
+TEST(Random, ThreadDrbg) {
+    Buffer first(3000);
+    Buffer second(3000);
+    ASSERT_TRUE(utils::RandomBytes(first.data(), first.size()));
+    ASSERT_TRUE(utils::RandomBytes(second.data(), second.size()));   // crosses a refill
+    EXPECT_NE(first, second);
+    EXPECT_NE(first, Buffer(first.size(), 0));
+    
+    utils::ReseedRandom();
+    ASSERT_TRUE(utils::RandomBytes(first.data(), first.size()));
+    EXPECT_NE(first, second);
+    
+    Buffer other(3000);
+    std::thread([&] { utils::RandomBytes(other.data(), other.size()); }).join();
+    EXPECT_NE(first, other);
+    
+#ifndef _WIN32
+    // Child must not repeat bytes the parent has buffered.
+    int fds[2] = {};
+    ASSERT_EQ(pipe(fds), 0);
+    const pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        uint8_t bytes[32] = {};
+        utils::RandomBytes(bytes, sizeof(bytes));
+        _exit(write(fds[1], bytes, sizeof(bytes)) == sizeof(bytes) ? 0 : 1);
+    }
+    close(fds[1]);
+    Buffer child(32);
+    EXPECT_EQ(read(fds[0], child.data(), child.size()), 32);
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    EXPECT_EQ(status, 0);
+    
+    Buffer parent(32);
+    ASSERT_TRUE(utils::RandomBytes(parent.data(), parent.size()));
+    EXPECT_NE(parent, child);
+#endif
+    
+    SRPVerifierGenerator gen(DigestType::SHA256, SRPBits::Key1024);
+    Buffer salt1, salt2, verifier;
+    gen.generate("user", "password", 16, salt1, verifier);
+    gen.generate("user", "password", 16, salt2, verifier);
+    EXPECT_EQ(salt1.size(), 16);
+    EXPECT_NE(salt1, salt2);
+}
+
+TEST(BignumBackend, ModularArithmetic) {
+    BN_CTX* ctx = bn::ThreadContext();
+    for (SRPBits bits : { SRPBits::Key1024, SRPBits::Key4096 }) {
+        const BIGNUM* N = SRPRoutines::gN(bits)->N;
+        const size_t size = BN_num_bytes(N);
+        auto mont = bn::MakeMontContext(N);
+        auto big = bn::Random(2 * size);
+        for (int i = 0; i < 8; i++) {
+            auto a = bn::Random(size - 1);
+            auto b = i == 0 ? bn::New() : bn::Random(i * size / 8 + 1);
+            auto expected = bn::New();
+            auto actual = bn::New();
+            
+            ASSERT_TRUE(BN_mod_mul(expected.get(), a.get(), b.get(), N, ctx));
+            ASSERT_TRUE(bn::ModMul(actual.get(), a.get(), b.get(), N, ctx));
+            EXPECT_EQ(bn::Compare(actual.get(), expected.get()), 0);
+            
+            ASSERT_TRUE(BN_mod_add(expected.get(), a.get(), b.get(), N, ctx));
+            ASSERT_TRUE(bn::ModAdd(actual.get(), a.get(), b.get(), N, ctx));
+            EXPECT_EQ(bn::Compare(actual.get(), expected.get()), 0);
+            
+            ASSERT_TRUE(BN_mod_sub(expected.get(), b.get(), a.get(), N, ctx));
+            ASSERT_TRUE(bn::ModSub(actual.get(), b.get(), a.get(), N, ctx));
+            EXPECT_EQ(bn::Compare(actual.get(), expected.get()), 0);
+            
+            ASSERT_TRUE(BN_mod_exp(expected.get(), a.get(), b.get(), N, ctx));
+            ASSERT_TRUE(bn::ModExp(actual.get(), a.get(), b.get(), N, mont.get(), ctx));
+            EXPECT_EQ(bn::Compare(actual.get(), expected.get()), 0);
+            
+            ASSERT_TRUE(BN_nnmod(expected.get(), big.get(), N, ctx));
+            ASSERT_TRUE(bn::Mod(actual.get(), big.get(), N, ctx));
+            EXPECT_EQ(bn::Compare(actual.get(), expected.get()), 0);
+            
+            EXPECT_EQ(bn::Compare(a.get(), N), -1);
+            EXPECT_EQ(bn::Compare(big.get(), N), 1);
+        }
+    }
+}
+
+TEST(MontKernel, MatchesModExp) {
+    BN_CTX* ctx = bn::ThreadContext();
+    for (SRPBits bits : { SRPBits::Key1024, SRPBits::Key1536, SRPBits::Key2048, SRPBits::Key3072,
+                          SRPBits::Key4096, SRPBits::Key6144, SRPBits::Key8192 }) {
+        const SRP_gN* gn = SRPRoutines::gN(bits);
+        const size_t size = BN_num_bytes(gn->N);
+        auto mont = bn::MakeMontContext(gn->N);
+        auto Nminus1 = bn::Own(BN_dup(gn->N));
+        BN_sub_word(Nminus1.get(), 1);
+        auto Nplus2 = bn::Own(BN_dup(gn->N));
+        BN_add_word(Nplus2.get(), 2);
+        
+        for (auto path : { bn::MontKernelPath::OpenSSL, bn::MontKernel::SupportedPath() }) {
+            bn::MontKernel kernel(gn->N, mont, path);
+            EXPECT_EQ(kernel.path(), path);
+            
+            const std::vector<bn::BignumPtr> bases = { bn::FromBytes(Buffer(1, 0)), bn::FromBytes(Buffer(1, 2)),
+                                                       Nminus1, Nplus2, bn::Random(size) };
+            for (const auto& base : bases) {
+                for (size_t exponentBits : { 0, 1, 7, 64, 256, 1000 }) {
+                    auto p = bn::RandomBits(exponentBits);
+                    auto expected = bn::New();
+                    auto actual = bn::New();
+                    ASSERT_TRUE(bn::ModExp(expected.get(), base.get(), p.get(), gn->N, mont.get(), ctx));
+                    ASSERT_TRUE(kernel.exp(actual.get(), base.get(), p.get(), ctx));
+                    EXPECT_EQ(bn::ToBytes(actual.get()), bn::ToBytes(expected.get())) << size << " " << exponentBits;
+                }
+            }
+        }
+    }
+    
+    // Moduli of other sizes always use OpenSSL.
+    auto m = bn::RandomBits(1000);
+    BN_set_bit(m.get(), 0);
+    EXPECT_EQ(bn::MontKernel(m.get(), bn::MakeMontContext(m.get()), bn::MontKernelPath::AVX512IFMA).path(), bn::MontKernelPath::OpenSSL);
+}
+
+TEST(SRPRoutines, NativeExponentiation) {
+    const std::string username = "user@mail.com";
+    const std::string password = "password";
+    for (SRPBits bits : { SRPBits::Key1024, SRPBits::Key3072 }) {
+        SRPVerifierGenerator gen(DigestType::SHA256, bits);
+        Buffer salt;
+        Buffer verifier;
+        gen.generate(username, password, 16, salt, verifier);
+        
+        SRPClient client(DigestType::SHA256, bits);
+        SRPServer server(DigestType::SHA256, bits);
+        client.routines.useNativeExponentiation();
+        server.routines.useNativeExponentiation();
+        server.routines.useFixedBaseExponentiation(4);
+        
+        Buffer A, B, M1, M2;
+        client.startAuthentication(A);
+        server.startAuthentication(username, salt, verifier, B);
+        ASSERT_TRUE(client.processChallenge(username, password, salt, B, M1));
+        ASSERT_TRUE(server.verifySession(A, M1, M2));
+        ASSERT_TRUE(client.verifySession(M2));
+        EXPECT_EQ(client.sessionKey(), server.sessionKey());
+    }
+}
+
+TEST(SRPRoutines, ParallelExponentiation) {
+    const std::string username = "user@mail.com";
+    const std::string password = "password";
+    auto pool = std::make_shared<utils::ThreadPool>(3);
+    for (SRPBits bits : { SRPBits::Key1024, SRPBits::Key4096 }) {
+        SRPServer reference(DigestType::SHA256, bits);
+        SRPRoutines routines;
+        routines.useParallelExponentiation(pool);
+        
+        const auto e = reference.routines.randomBN(reference.params);
+        const auto v = bn::Random(16);
+        const auto k = reference.routines.calculate_k(reference.params);
+        EXPECT_EQ(BN_cmp(routines.calculate_A(reference.params, e.get()).get(),
+                         reference.routines.calculate_A(reference.params, e.get()).get()), 0);
+        EXPECT_EQ(BN_cmp(routines.calculate_B(reference.params, e.get(), v.get(), k.get()).get(),
+                         reference.routines.calculate_B(reference.params, e.get(), v.get(), k.get()).get()), 0);
+        
+        SRPVerifierGenerator gen(DigestType::SHA256, bits);
+        Buffer salt;
+        Buffer verifier;
+        gen.generate(username, password, 16, salt, verifier);
+        
+        SRPClient client(DigestType::SHA256, bits);
+        SRPServer server(DigestType::SHA256, bits);
+        client.routines.useParallelExponentiation(pool, 4);
+        server.routines.useParallelExponentiation(pool);
+        
+        Buffer A, B, M1, M2;
+        client.startAuthentication(A);
+        server.startAuthentication(username, salt, verifier, B);
+        ASSERT_TRUE(client.processChallenge(username, password, salt, B, M1));
+        ASSERT_TRUE(server.verifySession(A, M1, M2));
+        ASSERT_TRUE(client.verifySession(M2));
+        EXPECT_EQ(client.sessionKey(), server.sessionKey());
+    }
+}
+
+TEST(SRPGroup, Registry) {
+    const SRP_gN* gn = SRPRoutines::gN(SRPBits::Key2048);
+    const SRPGroup* group = SRPGroup::Get(gn, DigestType::SHA256, SRPFlagSkipZeroes_M1_M2);
+    ASSERT_NE(group, nullptr);
+    EXPECT_EQ(group, SRPGroup::Get(gn, DigestType::SHA256, SRPFlagSkipZeroes_M1_M2));
+    EXPECT_NE(group, SRPGroup::Get(gn, DigestType::SHA256, Flags{}));
+    EXPECT_EQ(group->bignumSize, 256);
+    
+    const utils::Digest di(DigestType::SHA256);
+    const auto k = di.hash({ bn::ToBytes(gn->N, 256), bn::ToBytes(gn->g, 256) });
+    EXPECT_EQ(bn::ToBytes(group->k), k);
+    
+    SRPServer server(DigestType::SHA256, SRPBits::Key2048);
+    EXPECT_EQ(&SRPGroup::Get(server.params), SRPGroup::Get(gn, DigestType::SHA256, Flags{}));
+    server.params.flags = SRPFlagSkipZeroes_M1_M2;
+    EXPECT_EQ(&SRPGroup::Get(server.params), group);
+}
+
+TEST(SRPGroup, CustomGroupAtReusedAddress) {
+    EXPECT_EQ(SRPGroup::Get(nullptr, DigestType::SHA256, Flags{}), nullptr);
+    
+    const SRP_gN* gn1024 = SRPRoutines::gN(SRPBits::Key1024);
+    const SRP_gN* gn2048 = SRPRoutines::gN(SRPBits::Key2048);
+    
+    // Same SRP_gN object with other N and g, as a freed and reallocated custom group would be.
+    SRP_gN custom = { const_cast<char*>("custom"), gn1024->g, gn1024->N };
+    const SRPGroup* first = SRPGroup::Get(&custom, DigestType::SHA256, Flags{});
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(first->bignumSize, 128);
+    auto table = first->fixedBaseTable(256, 4);
+    
+    custom.g = gn2048->g;
+    custom.N = gn2048->N;
+    const SRPGroup* second = SRPGroup::Get(&custom, DigestType::SHA256, Flags{});
+    ASSERT_NE(second, nullptr);
+    EXPECT_EQ(second->bignumSize, 256);
+    EXPECT_EQ(bn::ToBytes(second->k), bn::ToBytes(SRPGroup::Get(gn2048, DigestType::SHA256, Flags{})->k));
+    EXPECT_NE(second->fixedBaseTable(256, 4), table);
+    EXPECT_EQ(first->bignumSize, 128);   // still alive for params pointing to it
+    
+    SRPParams params = { nullptr, DigestType::SHA256 };
+    EXPECT_DEATH(SRPGroup::Get(params), "gn is not set");
+}
+
+namespace {
+    Buffer FromHex(const std::string& hex) {
+        Buffer result;
+        for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+            result.push_back(static_cast<uint8_t>(std::stoul(hex.substr(i, 2), nullptr, 16)));
+        }
+        return result;
+    }
+}
+
+// Test vectors from RFC 5054, Appendix B.
+TEST(SRPVectors, RFC5054) {
+    const std::string username = "alice";
+    const std::string password = "password123";
+    const Buffer salt = FromHex("BEB25379D1A8581EB5A727673A2441EE");
+    const Buffer a = FromHex("60975527035CF2AD1989806F0407210BC81EDC04E2762A56AFD529DDDA2D4393");
+    const Buffer b = FromHex("E487CB59D31AC550471E81F00F6928E01DDA08E974A004F49E61F5D105284D20");
+    const Buffer expectedV = FromHex(
+        "7E273DE8696FFC4F4E337D05B4B375BEB0DDE1569E8FA00A9886D8129BADA1F1822223CA1A605B530E379BA4729FDC59"
+        "F105B4787E5186F5C671085A1447B52A48CF1970B4FB6F8400BBF4CEBFBB168152E08AB5EA53D15C1AFF87B2B9DA6E04"
+        "E058AD51CC72BFC9033B564E26480D78E955A5E29E7AB245DB2BE315E2099AFB");
+    const Buffer expectedA = FromHex(
+        "61D5E490F6F1B79547B0704C436F523DD0E560F0C64115BB72557EC44352E8903211C04692272D8B2D1A5358A2CF1B6E"
+        "0BFCF99F921530EC8E39356179EAE45E42BA92AEACED825171E1E8B9AF6D9C03E1327F44BE087EF06530E69F66615261"
+        "EEF54073CA11CF5858F0EDFDFE15EFEAB349EF5D76988A3672FAC47B0769447B");
+    const Buffer expectedB = FromHex(
+        "BD0C61512C692C0CB6D041FA01BB152D4916A1E77AF46AE105393011BAF38964DC46A0670DD125B95A981652236F99D9"
+        "B681CBF87837EC996C6DA04453728610D0C6DDB58B318885D7D82C7F8DEB75CE7BD4FBAA37089E6F9C6059F388838E7A"
+        "00030B331EB76840910440B1B27AAEAEEB4012B7D7665238A8E3FB004B117B58");
+    const Buffer expectedS = FromHex(
+        "B0DC82BABCF30674AE450C0287745E7990A3381F63B387AAF271A10D233861E359B48220F7C4693C9AE12B0A6F67809F"
+        "0876E2D013800D6C41BB59B6D5979B5C00A172B4A2A5903A0BDCAF8A709585EB2AFAFA8F3499B200210DCC1F10EB3394"
+        "3CD67FC88A2F39A4BE5BEC4EC0A3212DC346D7E474B29EDE8A469FFECA686E5A");
+    
+    SRPVerifierGenerator gen(DigestType::SHA1, SRPBits::Key1024);
+    Buffer verifier;
+    gen.generate(username, password, salt, verifier);
+    EXPECT_EQ(verifier, expectedV);
+    
+    SRPClient client(DigestType::SHA1, SRPBits::Key1024);
+    client.routines.randomBN = [&a](const SRPParams&) { return bn::FromBytes(a); };
+    Buffer A;
+    client.startAuthentication(A);
+    EXPECT_EQ(A, expectedA);
+    
+    SRPClient shortClient(DigestType::SHA1, SRPBits::Key1024);
+    shortClient.params.ephemeralBits = 256;
+    Buffer shortA;
+    shortClient.insecure_startAuthentication(a, shortA);
+    EXPECT_EQ(shortA, expectedA);
+    
+    SRPServer server(DigestType::SHA1, SRPBits::Key1024);
+    server.routines.randomBN = [&b](const SRPParams&) { return bn::FromBytes(b); };
+    Buffer B;
+    server.startAuthentication(username, salt, verifier, B);
+    EXPECT_EQ(B, expectedB);
+    
+    Buffer M1;
+    ASSERT_TRUE(client.processChallenge(username, password, salt, B, M1));
+    Buffer M2;
+    ASSERT_TRUE(server.verifySession(A, M1, M2));
+    ASSERT_TRUE(client.verifySession(M2));
+    
+    const Buffer expectedK = utils::Digest(DigestType::SHA1).hash({ expectedS });
+    EXPECT_EQ(client.sessionKey(), expectedK);
+    EXPECT_EQ(server.sessionKey(), expectedK);
+}
@@ -0,0 +1,62 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <simplesrp/details.h>
+
+#include <map>
+#include <string>
+
+namespace simplesrp::tools {
+    inline bool ParseBits(const char* str, SRPBits& bits) {
+        static const std::map<std::string, SRPBits> s_bits = {
+            { "1024", SRPBits::Key1024 }, { "1536", SRPBits::Key1536 }, { "2048", SRPBits::Key2048 },
+            { "3072", SRPBits::Key3072 }, { "4096", SRPBits::Key4096 }, { "6144", SRPBits::Key6144 },
+            { "8192", SRPBits::Key8192 },
+        };
+        auto it = s_bits.find(str);
+        return it != s_bits.end() ? (bits = it->second, true) : false;
+    }
+    
+    inline bool ParseDigest(const char* str, DigestType& digestType) {
+        static const std::map<std::string, DigestType> s_digests = {
+            { "sha1", DigestType::SHA1 }, { "sha224", DigestType::SHA224 }, { "sha256", DigestType::SHA256 },
+            { "sha384", DigestType::SHA384 }, { "sha512", DigestType::SHA512 },
+        };
+        auto it = s_digests.find(str);
+        return it != s_digests.end() ? (digestType = it->second, true) : false;
+    }
+    
+    inline const char* DigestName(DigestType digestType) {
+        switch (digestType) {
+        case DigestType::SHA1: return "sha1";
+        case DigestType::SHA224: return "sha224";
+        case DigestType::SHA256: return "sha256";
+        case DigestType::SHA384: return "sha384";
+        case DigestType::SHA512: return "sha512";
+        default: return "unknown";
+        }
+    }
+}
@@ -0,0 +1,446 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Common.h"
+
+#include <simplesrp/simplesrp.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace simplesrp;
+using namespace simplesrp::tools;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+    
+    void PrintUsage() {
+        fprintf(stderr,
+                "Usage:\n"
+                "  simplesrp_loadgen [options]\n"
+                "      Runs complete handshakes of client threads against server workers in one process.\n"
+                "      --bits <1024|1536|2048|3072|4096|6144|8192>  (default 2048)\n"
+                "      --digest <sha1|sha224|sha256|sha384|sha512>  (default sha256)\n"
+                "      --no-username-in-x\n"
+                "      --skip-zeroes-k-u-x\n"
+                "      --skip-zeroes-m1-m2\n"
+                "      --ephemeral <bits>                           (default: size of N)\n"
+                "      --clients <count>                            (default 4)\n"
+                "      --servers <count>                            (default: hardware threads)\n"
+                "      --rate <handshakes/s>                        (default 0: flat out)\n"
+                "      --duration <seconds>                         (default 10)\n"
+                "      --users <count>                              (default 64)\n");
+    }
+    
+    /// Log-linear histogram of durations in nanoseconds: 16 buckets per power of two, ~6% resolution.
+    class Histogram {
+    public:
+        void record(Clock::duration duration) {
+            const uint64_t value = static_cast<uint64_t>(std::max<int64_t>(0, std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count()));
+            m_counts[Index(value)]++;
+            m_count++;
+            m_max = std::max(m_max, value);
+        }
+        
+        void merge(const Histogram& other) {
+            for (size_t i = 0; i < m_counts.size(); i++) {
+                m_counts[i] += other.m_counts[i];
+            }
+            m_count += other.m_count;
+            m_max = std::max(m_max, other.m_max);
+        }
+        
+        uint64_t count() const { return m_count; }
+        uint64_t max() const { return m_max; }
+        
+        /// Upper bound of the bucket holding the `fraction` quantile.
+        uint64_t percentile(double fraction) const {
+            const uint64_t rank = static_cast<uint64_t>(fraction * static_cast<double>(m_count - 1)) + 1;
+            uint64_t seen = 0;
+            for (size_t i = 0; i < m_counts.size(); i++) {
+                seen += m_counts[i];
+                if (m_count && seen >= rank) {
+                    return std::min(UpperBound(i), m_max);
+                }
+            }
+            return m_max;
+        }
+        
+    private:
+        static constexpr size_t SubBuckets = 16;
+        
+        static size_t Index(uint64_t value) {
+            if (value < SubBuckets) {
+                return static_cast<size_t>(value);
+            }
+            size_t shift = 0;
+            while ((value >> shift) >= 2 * SubBuckets) {
+                shift++;
+            }
+            return (shift + 1) * SubBuckets + static_cast<size_t>((value >> shift) - SubBuckets);
+        }
+        
+        static uint64_t UpperBound(size_t index) {
+            if (index < SubBuckets) {
+                return index;
+            }
+            const size_t shift = index / SubBuckets - 1;
+            const uint64_t lower = static_cast<uint64_t>(SubBuckets + index % SubBuckets) << shift;
+            return lower + (uint64_t(1) << shift) - 1;
+        }
+        
+    private:
+        std::array<uint64_t, 61 * SubBuckets> m_counts = {};
+        uint64_t m_count = 0;
+        uint64_t m_max = 0;
+    };
+    
+    enum Phase {
+        ClientStartAuthentication,
+        ServerStartAuthentication,
+        ClientProcessChallenge,
+        ServerVerifySession,
+        ClientVerifySession,
+        Handshake,
+        PhaseCount,
+    };
+    
+    const char* const kPhaseNames[PhaseCount] = {
+        "client.startAuthentication",
+        "server.startAuthentication",
+        "client.processChallenge",
+        "server.verifySession",
+        "client.verifySession",
+        "handshake",
+    };
+    
+    /// Owned by one thread while it runs, merged when all threads have finished.
+    struct Stats {
+        std::array<Histogram, PhaseCount> phases;
+        uint64_t failed = 0;
+        
+        template <class Fn>
+        auto measure(Phase phase, Fn&& fn) {
+            const auto start = Clock::now();
+            auto result = fn();
+            phases[phase].record(Clock::now() - start);
+            return result;
+        }
+    };
+    
+    struct Config {
+        SRPBits bits = SRPBits::Key2048;
+        DigestType digestType = DigestType::SHA256;
+        Flags flags = {};
+        size_t ephemeralBits = 0;
+        size_t clients = 4;
+        size_t servers = 0;
+        double rate = 0;
+        double duration = 10;
+        size_t users = 64;
+    };
+    
+    /// Handshake in flight: the server side travels with messages between server workers.
+    struct Connection {
+        SRPServer server;
+        const SRPVerifierGenerator::Record* user = nullptr;
+        Buffer A, B, M1, M2;
+        bool ok = false;
+        
+        std::mutex lock;
+        std::condition_variable cv;
+        bool replied = false;
+        
+        explicit Connection(const Config& config) : server(config.digestType, config.bits) {
+            server.params.flags = config.flags;
+            server.params.ephemeralBits = config.ephemeralBits;
+        }
+        
+        void reply(bool result) {
+            std::lock_guard<std::mutex> guard(lock);
+            ok = result;
+            replied = true;
+            cv.notify_one();
+        }
+        
+        bool wait() {
+            std::unique_lock<std::mutex> guard(lock);
+            cv.wait(guard, [this] { return replied; });
+            replied = false;
+            return ok;
+        }
+    };
+    
+    struct Message {
+        Connection* connection = nullptr;
+        Phase phase = ServerStartAuthentication;
+    };
+    
+    /// Unbounded MPMC queue between client threads and server workers.
+    class MessageQueue {
+    public:
+        void push(Message message) {
+            {
+                std::lock_guard<std::mutex> guard(m_lock);
+                m_messages.push_back(message);
+            }
+            m_cv.notify_one();
+        }
+        
+        /// Returns false once the queue is closed and empty.
+        bool pop(Message& message) {
+            std::unique_lock<std::mutex> guard(m_lock);
+            m_cv.wait(guard, [this] { return m_closed || !m_messages.empty(); });
+            if (m_messages.empty()) {
+                return false;
+            }
+            message = m_messages.front();
+            m_messages.pop_front();
+            return true;
+        }
+        
+        void close() {
+            {
+                std::lock_guard<std::mutex> guard(m_lock);
+                m_closed = true;
+            }
+            m_cv.notify_all();
+        }
+        
+    private:
+        std::deque<Message> m_messages;
+        std::mutex m_lock;
+        std::condition_variable m_cv;
+        bool m_closed = false;
+    };
+    
+    void ServerWorker(MessageQueue& queue, Stats& stats) {
+        Message message;
+        while (queue.pop(message)) {
+            Connection& connection = *message.connection;
+            const auto& user = *connection.user;
+            if (message.phase == ServerStartAuthentication) {
+                stats.measure(ServerStartAuthentication, [&] {
+                    connection.server.startAuthentication(user.username, user.salt, user.verifier, connection.B);
+                    return true;
+                });
+                connection.reply(!connection.B.empty());
+            } else {
+                const bool verified = stats.measure(ServerVerifySession, [&] {
+                    return connection.server.verifySession(connection.A, connection.M1, connection.M2);
+                });
+                connection.reply(verified);
+            }
+        }
+    }
+    
+    void ClientThread(const Config& config, const std::vector<SRPVerifierGenerator::Record>& users, size_t index,
+                      MessageQueue& queue, Clock::time_point start, Clock::time_point deadline, Stats& stats) {
+        std::minstd_rand random(static_cast<uint32_t>(index + 1));
+        
+        // With a target rate every client runs its share on a fixed schedule. Latency is counted
+        // from the scheduled start, so a saturated server does not hide queueing delay.
+        const auto interval = config.rate > 0
+            ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(config.clients / config.rate))
+            : Clock::duration::zero();
+        auto scheduled = start + interval * index / config.clients;
+        
+        while (true) {
+            Clock::time_point begin = Clock::now();
+            if (config.rate > 0) {
+                std::this_thread::sleep_until(scheduled);
+                begin = scheduled;
+                scheduled += interval;
+            }
+            if (begin >= deadline) {
+                break;
+            }
+            
+            SRPClient client(config.digestType, config.bits);
+            client.params.flags = config.flags;
+            client.params.ephemeralBits = config.ephemeralBits;
+            Connection connection(config);
+            connection.user = &users[random() % users.size()];
+            const auto& user = *connection.user;
+            
+            stats.measure(ClientStartAuthentication, [&] {
+                client.startAuthentication(connection.A);
+                return true;
+            });
+            queue.push({ &connection, ServerStartAuthentication });
+            bool ok = connection.wait();
+            
+            ok = ok && stats.measure(ClientProcessChallenge, [&] {
+                return client.processChallenge(user.username, user.password, user.salt, connection.B, connection.M1);
+            });
+            if (ok) {
+                queue.push({ &connection, ServerVerifySession });
+                ok = connection.wait();
+            }
+            ok = ok && stats.measure(ClientVerifySession, [&] {
+                return client.verifySession(connection.M2);
+            });
+            
+            if (ok) {
+                stats.phases[Handshake].record(Clock::now() - begin);
+            } else {
+                stats.failed++;
+            }
+        }
+    }
+    
+    bool ParseOptions(int argc, char** argv, Config& config) {
+        for (int i = 0; i < argc; i++) {
+            const bool hasValue = i + 1 < argc;
+            if (strcmp(argv[i], "--no-username-in-x") == 0) {
+                config.flags |= SRPFlagNoUsernameInX;
+            } else if (strcmp(argv[i], "--skip-zeroes-k-u-x") == 0) {
+                config.flags |= SRPFlagSkipZeroes_k_U_X;
+            } else if (strcmp(argv[i], "--skip-zeroes-m1-m2") == 0) {
+                config.flags |= SRPFlagSkipZeroes_M1_M2;
+            } else if (strcmp(argv[i], "--bits") == 0 && hasValue && ParseBits(argv[i + 1], config.bits)) {
+                i++;
+            } else if (strcmp(argv[i], "--digest") == 0 && hasValue && ParseDigest(argv[i + 1], config.digestType)) {
+                i++;
+            } else if (strcmp(argv[i], "--ephemeral") == 0 && hasValue) {
+                config.ephemeralBits = strtoul(argv[++i], nullptr, 10);
+            } else if (strcmp(argv[i], "--clients") == 0 && hasValue) {
+                config.clients = strtoul(argv[++i], nullptr, 10);
+            } else if (strcmp(argv[i], "--servers") == 0 && hasValue) {
+                config.servers = strtoul(argv[++i], nullptr, 10);
+            } else if (strcmp(argv[i], "--rate") == 0 && hasValue) {
+                config.rate = strtod(argv[++i], nullptr);
+            } else if (strcmp(argv[i], "--duration") == 0 && hasValue) {
+                config.duration = strtod(argv[++i], nullptr);
+            } else if (strcmp(argv[i], "--users") == 0 && hasValue) {
+                config.users = strtoul(argv[++i], nullptr, 10);
+            } else {
+                fprintf(stderr, "Invalid option: %s\n", argv[i]);
+                return false;
+            }
+        }
+        
+        if (!config.servers) {
+            config.servers = std::max(1u, std::thread::hardware_concurrency());
+        }
+        return config.clients && config.users && config.duration > 0 && config.rate >= 0;
+    }
+    
+    void PrintReport(const Config& config, const Stats& total, double elapsed) {
+        const uint64_t completed = total.phases[Handshake].count();
+        char rate[32] = "flat out";
+        if (config.rate > 0) {
+            snprintf(rate, sizeof(rate), "%g/s", config.rate);
+        }
+        printf("%zu bits, %s, flags 0x%x, ephemeral %zu bits, %zu clients, %zu servers, rate %s\n",
+               BignumSize(config.bits) * 8, DigestName(config.digestType), static_cast<unsigned>(config.flags),
+               config.ephemeralBits, config.clients, config.servers, rate);
+        printf("%llu handshakes in %.2f s: %.1f/s, %llu failed\n\n",
+               static_cast<unsigned long long>(completed), elapsed, completed / elapsed,
+               static_cast<unsigned long long>(total.failed));
+        
+        printf("%-28s %10s %10s %10s %10s %10s %10s\n", "phase (us)", "count", "p50", "p90", "p99", "p999", "max");
+        for (size_t i = 0; i < PhaseCount; i++) {
+            const Histogram& histogram = total.phases[i];
+            if (!histogram.count()) {
+                continue;
+            }
+            printf("%-28s %10llu %10.1f %10.1f %10.1f %10.1f %10.1f\n", kPhaseNames[i],
+                   static_cast<unsigned long long>(histogram.count()),
+                   histogram.percentile(0.5) / 1e3, histogram.percentile(0.9) / 1e3,
+                   histogram.percentile(0.99) / 1e3, histogram.percentile(0.999) / 1e3,
+                   histogram.max() / 1e3);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    Config config;
+    if (!ParseOptions(argc - 1, argv + 1, config)) {
+        PrintUsage();
+        return 1;
+    }
+    
+    SRPVerifierGenerator gen(config.digestType, config.bits);
+    gen.params.flags = config.flags;
+    std::vector<SRPVerifierGenerator::Record> users(config.users);
+    for (size_t i = 0; i < users.size(); i++) {
+        users[i].username = "user" + std::to_string(i) + "@mail.com";
+        users[i].password = "password" + std::to_string(i);
+        users[i].saltSize = 16;
+    }
+    if (!gen.generate(users)) {
+        fprintf(stderr, "Failed to generate verifiers\n");
+        return 1;
+    }
+    
+    MessageQueue queue;
+    std::vector<Stats> serverStats(config.servers);
+    std::vector<Stats> clientStats(config.clients);
+    std::vector<std::thread> servers;
+    std::vector<std::thread> clients;
+    for (size_t i = 0; i < config.servers; i++) {
+        servers.emplace_back(ServerWorker, std::ref(queue), std::ref(serverStats[i]));
+    }
+    
+    const auto start = Clock::now();
+    const auto deadline = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(config.duration));
+    for (size_t i = 0; i < config.clients; i++) {
+        clients.emplace_back(ClientThread, std::cref(config), std::cref(users), i, std::ref(queue),
+                             start, deadline, std::ref(clientStats[i]));
+    }
+    for (auto& thread : clients) {
+        thread.join();
+    }
+    const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    
+    queue.close();
+    for (auto& thread : servers) {
+        thread.join();
+    }
+    
+    Stats total;
+    for (const auto& stats : clientStats) {
+        for (size_t i = 0; i < PhaseCount; i++) {
+            total.phases[i].merge(stats.phases[i]);
+        }
+        total.failed += stats.failed;
+    }
+    for (const auto& stats : serverStats) {
+        for (size_t i = 0; i < PhaseCount; i++) {
+            total.phases[i].merge(stats.phases[i]);
+        }
+    }
+    PrintReport(config, total, elapsed);
+    return total.failed ? 2 : 0;
+}
@@ -0,0 +1,155 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Common.h"
+
+#include <simplesrp/store.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+using namespace simplesrp;
+using namespace simplesrp::tools;
+
+namespace {
+    void PrintUsage() {
+        fprintf(stderr,
+                "Usage:\n"
+                "  simplesrp_store build [options] <input> <output>\n"
+                "      <input> has one 'username<TAB>password' per line.\n"
+                "      --bits <1024|1536|2048|3072|4096|6144|8192>  (default 2048)\n"
+                "      --digest <sha1|sha224|sha256|sha384|sha512>  (default sha256)\n"
+                "      --salt <bytes>                               (default 16)\n"
+                "      --threads <count>                            (default: hardware threads)\n"
+                "      --no-username-in-x\n"
+                "  simplesrp_store lookup <store> <username>\n");
+    }
+    
+    void PrintHex(const char* name, const uint8_t* data, size_t size) {
+        printf("%s: ", name);
+        for (size_t i = 0; i < size; i++) {
+            printf("%02x", data[i]);
+        }
+        printf("\n");
+    }
+    
+    int Build(int argc, char** argv) {
+        SRPBits bits = SRPBits::Key2048;
+        DigestType digestType = DigestType::SHA256;
+        size_t saltSize = 16;
+        size_t threadCount = 0;
+        Flags flags = {};
+        
+        int i = 0;
+        for (; i < argc && strncmp(argv[i], "--", 2) == 0; i++) {
+            const bool hasValue = i + 1 < argc;
+            if (strcmp(argv[i], "--no-username-in-x") == 0) {
+                flags |= SRPFlagNoUsernameInX;
+            } else if (strcmp(argv[i], "--bits") == 0 && hasValue && ParseBits(argv[i + 1], bits)) {
+                i++;
+            } else if (strcmp(argv[i], "--digest") == 0 && hasValue && ParseDigest(argv[i + 1], digestType)) {
+                i++;
+            } else if (strcmp(argv[i], "--salt") == 0 && hasValue) {
+                saltSize = strtoul(argv[++i], nullptr, 10);
+            } else if (strcmp(argv[i], "--threads") == 0 && hasValue) {
+                threadCount = strtoul(argv[++i], nullptr, 10);
+            } else {
+                fprintf(stderr, "Invalid option: %s\n", argv[i]);
+                return 1;
+            }
+        }
+        if (argc - i != 2 || !saltSize) {
+            PrintUsage();
+            return 1;
+        }
+        
+        std::ifstream input(argv[i]);
+        if (!input) {
+            fprintf(stderr, "Failed to open %s\n", argv[i]);
+            return 1;
+        }
+        
+        SRPVerifierStoreBuilder builder(digestType, bits);
+        builder.generator.params.flags = flags;
+        
+        size_t count = 0;
+        std::string line;
+        while (std::getline(input, line)) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if (line.empty()) {
+                continue;
+            }
+            const size_t tab = line.find('\t');
+            if (tab == std::string::npos) {
+                fprintf(stderr, "Line %zu: expected 'username<TAB>password'\n", count + 1);
+                return 1;
+            }
+            builder.add(line.substr(0, tab), line.substr(tab + 1), saltSize);
+            count++;
+        }
+        
+        if (!builder.write(argv[i + 1], threadCount)) {
+            fprintf(stderr, "Failed to write %s (duplicate usernames?)\n", argv[i + 1]);
+            return 1;
+        }
+        printf("%zu records written to %s\n", count, argv[i + 1]);
+        return 0;
+    }
+    
+    int Lookup(int argc, char** argv) {
+        if (argc != 2) {
+            PrintUsage();
+            return 1;
+        }
+        
+        SRPVerifierStore store;
+        if (!store.open(argv[0])) {
+            fprintf(stderr, "Failed to open %s\n", argv[0]);
+            return 1;
+        }
+        
+        SRPVerifierView view;
+        if (!store.find(argv[1], strlen(argv[1]), view)) {
+            fprintf(stderr, "%s not found\n", argv[1]);
+            return 1;
+        }
+        PrintHex("salt", view.salt, view.saltSize);
+        PrintHex("verifier", view.verifier, view.verifierSize);
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 2 && strcmp(argv[1], "build") == 0) {
+        return Build(argc - 2, argv + 2);
+    }
+    if (argc >= 2 && strcmp(argv[1], "lookup") == 0) {
+        return Lookup(argc - 2, argv + 2);
+    }
+    PrintUsage();
+    return 1;
+}